@@ -6,6 +6,12 @@ uniform float u_time;
 uniform vec2 u_resolution;
 uniform float u_audioBass;
 uniform float u_audioTreble;
+uniform float u_onset; // decaying high-band onset pulse
+uniform float u_beatPhase;
+uniform float u_beatConfidence;
+uniform float u_anticipation; // rises ahead of a louder section (offline timeline lookahead)
+uniform vec3 u_spectralShape;  // centroid, rolloff, flatness, all 0..1
+uniform vec3 u_spectralMotion; // flux, crest, zero-crossing rate, all 0..1
 uniform int u_mode;
 uniform float u_intensity;
 uniform float u_speed;
@@ -78,16 +84,17 @@ float StarField(vec2 uv, float time) {
 
     // Soft background scatter to avoid perfect emptiness.
     float scatter = Noise(uv * 10.0 + vec2(time * 0.07)) * 0.08;
-    return clamp(peak * (1.7 + u_audioBass * 1.1) + scatter, 0.0, 3.0);
+    return clamp(peak * (1.7 + u_audioBass * 1.1 + u_onset * 0.8 + u_spectralMotion.x * 0.6) + scatter, 0.0, 3.0);
 }
 
 vec3 NebulaLayer(vec2 uv, float time) {
     vec2 p = uv * (1.3 + u_audioBass * 0.6);
     float swirl = fbm(p + vec2(time * 0.12), time);
     p += vec2(cos(swirl * 6.2831), sin(swirl * 6.2831)) * (0.25 + u_audioBass * 0.2);
-    float density = fbm(p * (1.0 + u_audioTreble), time) * 0.8;
+    // Noisier spectra (high flatness) roughen the nebula; brighter ones (high centroid) lean towards u_colorB.
+    float density = fbm(p * (1.0 + u_audioTreble + 0.5 * u_spectralShape.z), time) * 0.8;
     density = clamp(density, 0.0, 1.0);
-    vec3 color = mix(u_colorA, u_colorB, 0.5 + 0.5 * density);
+    vec3 color = mix(u_colorA, u_colorB, clamp(0.5 + 0.5 * density + 0.3 * (u_spectralShape.x - 0.5), 0.0, 1.0));
     color += vec3(density * 0.6 + u_audioTreble * 0.4);
     return clamp(color, 0.0, 1.0);
 }
@@ -111,6 +118,8 @@ void main() {
         float blend = clamp((nebula.r + nebula.g + nebula.b) / 3.0, 0.0, 1.0);
         color = mix(color, nebula, blend * 0.9 + 0.1);
     }
+    color *= 1.0 + 0.25 * u_beatConfidence * exp(-8.0 * u_beatPhase);
+    color *= 1.0 + 0.35 * u_anticipation;
     color *= clamp(u_intensity, 0.0, 2.0);
     outColor = vec4(clamp(color, 0.0, 1.0), 1.0);
 }
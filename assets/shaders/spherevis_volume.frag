@@ -1,17 +1,31 @@
 #version 430 core
 
+// Permutation switches, injected by the app per variant; the defaults match its default settings.
+#ifndef SHELL_MODE
+#define SHELL_MODE 0    // 0 ripple, 1 noise
+#endif
+#ifndef COLOR_MODE
+#define COLOR_MODE 1    // 0 density, 1 transfer function
+#endif
+#ifndef ENABLE_JITTER
+#define ENABLE_JITTER 1
+#endif
+#ifndef ENABLE_STATS
+#define ENABLE_STATS 0  // RayMarchStats counters; their atomics cost every pixel
+#endif
+
 layout(location = 0) out vec4 outColor;
+layout(location = 1) out float outDepth; // alpha-weighted distance along the ray, for the reduced-resolution upsample
 
 uniform mat4 uInvViewProj;
 uniform vec3 uCameraPos;
 uniform vec2 uScreenSize;
 uniform float uTime;
-uniform float uStepSize;
-uniform int uMaxSteps;
+uniform float uTolerance; // opacity error allowed per step; sets the step lengths
 uniform float uAlphaScale;
-uniform int uColorMode;
-uniform int uEnableJitter;
 uniform float uJitterSeed;
+uniform int uBlueNoise;         // uBlueNoiseTex loaded; otherwise the hash jitter is used
+uniform float uJitterRotation;  // golden-ratio sequence in the frame index, 0..1
 uniform vec3 uVolumeMin;
 uniform vec3 uVolumeMax;
 uniform float uNoiseStrength;
@@ -21,14 +35,49 @@ uniform float uRippleAmp;
 uniform float uRippleFreq;
 uniform float uRippleSpeed;
 uniform float uBass;
-uniform int uShellMode;
+uniform vec3 uOnsetPulse; // decaying low/mid/high onset pulses
+uniform float uBpm;             // 0 until the tracker has locked a period
+uniform float uBeatPhase;      // 0 on the beat, rising to 1 before the next one
+uniform float uBeatConfidence;
+uniform vec3 uSpectralShape;  // centroid, rolloff, flatness, all 0..1
+uniform vec3 uSpectralMotion; // flux, crest, zero-crossing rate, all 0..1
+uniform int uEnableSkipping;  // off when the warp could carry a sample further than one brick
+uniform int uBrickGrid;       // bricks per axis
+uniform float uBricksPerUnit; // bricks per unit of texture coordinate
+uniform vec2 uEmptyRange;     // densities at or below x read as the first LUT texel; at or above y alpha is zero
+uniform int uShellClipping;   // march only inside the shell intervals
+uniform float uShellPadding;  // radial reach of the warp and the trilinear filter beyond the intervals
+uniform int uPreintegrated;   // composite segments between samples from uPreintegratedLut
+uniform float uSpectrogramOffset; // SpectrogramHistory::GetWrapOffset: v of the oldest row
+uniform float uSpectrogramEcho;   // brightness the spectrogram history adds to the shells; 0 disables it
 layout(binding = 0) uniform sampler3D uVolumeTex;
 layout(binding = 1) uniform sampler2D uTransferLut;
+layout(binding = 2) uniform sampler3D uBrickTex; // min / max density of each brick's neighbourhood
+layout(binding = 3) uniform sampler2D uPreintegratedLut; // (front, back) density -> segment colour and opacity per reference step
+layout(binding = 4) uniform sampler2D uBlueNoiseTex;
+layout(binding = 5) uniform sampler3D uNoiseTex; // tileable value-noise lattice, one texel per unit
+layout(binding = 6) uniform sampler2D uSpectrogramTex; // ring of spectrum rows, repeating along v
 
+#if ENABLE_STATS
 layout(std430, binding = 0) buffer RayMarchStats {
     uint totalSteps;
     uint rayCount;
     uint earlyExitCount;
+    uint skippedLength; // in reference steps
+    uint marchedLength;
+};
+#endif
+
+const float kReferenceStep = 0.01; // LUT opacity is per this length; other steps are corrected to it
+const int kMaxSamples = 2048;
+const float kBeatPulseSeconds = 0.0625; // decay time of the beat pulse; App::RenderVolume bounds the warp with it
+
+const int kMaxShells = 32; // SphereVolumeData::kMaxShellIntervals
+
+// Sorted, disjoint [rMin, rMax] radii outside of which the field has no visible density.
+layout(std430, binding = 1) readonly buffer ShellIntervals {
+    int shellCount;
+    vec2 shells[];
 };
 
 float Hash(vec2 value) {
@@ -36,33 +85,74 @@ float Hash(vec2 value) {
 }
 
 float RandomJitter(vec2 coord, float seed) {
+    if (uBlueNoise == 1) {
+        // Tiled blue noise, rotated each frame, so neighbouring pixels and consecutive frames both stratify.
+        ivec2 size = textureSize(uBlueNoiseTex, 0);
+        float noise = texelFetch(uBlueNoiseTex, ivec2(coord) % size, 0).r;
+        return fract(noise + uJitterRotation);
+    }
     return Hash(coord + seed);
 }
 
-float Hash3(vec3 value) {
-    return fract(sin(dot(value, vec3(12.9898, 78.233, 37.719))) * 43758.5453);
-}
-
 float Noise3(vec3 point) {
-    vec3 i = floor(point);
+    // Fading the lattice coordinate with smoothstep lets the hardware trilinear filter blend the eight
+    // lattice values exactly as the smoothstep-weighted mix would. Wrapping first keeps precision as time grows.
+    vec3 size = vec3(textureSize(uNoiseTex, 0));
+    vec3 i = mod(floor(point), size);
     vec3 f = fract(point);
     vec3 u = f * f * (3.0 - 2.0 * f);
-    float n000 = Hash3(i + vec3(0.0));
-    float n100 = Hash3(i + vec3(1.0, 0.0, 0.0));
-    float n010 = Hash3(i + vec3(0.0, 1.0, 0.0));
-    float n110 = Hash3(i + vec3(1.0, 1.0, 0.0));
-    float n001 = Hash3(i + vec3(0.0, 0.0, 1.0));
-    float n101 = Hash3(i + vec3(1.0, 0.0, 1.0));
-    float n011 = Hash3(i + vec3(0.0, 1.0, 1.0));
-    float n111 = Hash3(i + vec3(1.0, 1.0, 1.0));
-
-    float nx00 = mix(n000, n100, u.x);
-    float nx10 = mix(n010, n110, u.x);
-    float nx01 = mix(n001, n101, u.x);
-    float nx11 = mix(n011, n111, u.x);
-    float nxy0 = mix(nx00, nx10, u.y);
-    float nxy1 = mix(nx01, nx11, u.y);
-    return mix(nxy0, nxy1, u.z);
+    return texture(uNoiseTex, (i + u + 0.5) / size).r;
+}
+
+// Ray parameters entering and leaving the sphere of the given radius; x > y when the ray misses it.
+vec2 SphereHits(vec3 origin, vec3 dir, float radius) {
+    float b = dot(origin, dir);
+    float h = b * b - (dot(origin, origin) - radius * radius);
+    if (radius <= 0.0 || h < 0.0) {
+        return vec2(1.0, -1.0);
+    }
+    h = sqrt(h);
+    return vec2(-b - h, -b + h);
+}
+
+// Segment s of the ray inside the shells, in ray order: the near halves of the shells from the outside in,
+// then the far halves from the inside out. A shell whose hole the ray misses is a single near segment.
+vec2 ShellSegment(int s, int count, vec3 origin, vec3 dir) {
+    bool near = s < count;
+    vec2 interval = shells[near ? count - 1 - s : s - count] + vec2(-uShellPadding, uShellPadding);
+    vec2 outer = SphereHits(origin, dir, interval.y);
+    vec2 inner = SphereHits(origin, dir, interval.x);
+    if (outer.x > outer.y) {
+        return vec2(1.0, -1.0);
+    }
+    if (inner.x > inner.y) {
+        return near ? outer : vec2(1.0, -1.0);
+    }
+    return near ? vec2(outer.x, inner.x) : vec2(inner.y, outer.y);
+}
+
+// Segment s clipped to [start, end], or far behind the ray when empty so the march passes it by.
+// Between segments the density is below the first LUT texel's reach.
+vec2 RaySpan(int s, int count, vec3 origin, vec3 dir, float start, float end) {
+    vec2 span = uShellClipping == 1 ? ShellSegment(s, count, origin, dir) : vec2(start, end);
+    span = vec2(max(span.x, start), min(span.y, end));
+    return span.x <= span.y ? span : vec2(-1.0e3);
+}
+
+// A stretch of the first LUT texel at once, stopping where marching would have stopped.
+void CompositeBlank(float stretch, vec3 color, float alpha, inout vec3 accumColor, inout float accumAlpha, inout bool earlyExit) {
+    if (stretch <= 0.0 || alpha <= 0.0) {
+        return;
+    }
+    float remaining = 1.0 - accumAlpha;
+    float count = stretch / kReferenceStep;
+    if (alpha < 1.0) {
+        count = min(count, log(0.02 / remaining) / log(1.0 - alpha));
+    }
+    float transmit = pow(1.0 - alpha, count);
+    accumColor += remaining * color * (1.0 - transmit);
+    accumAlpha = 1.0 - remaining * transmit;
+    earlyExit = accumAlpha >= 0.98;
 }
 
 void main() {
@@ -81,57 +171,163 @@ void main() {
     float entry = max(max(tMin.x, tMin.y), tMin.z);
     float exit = min(min(tMax.x, tMax.y), tMax.z);
 
+#if ENABLE_STATS
     atomicAdd(rayCount, 1u);
+#endif
     if (exit <= max(entry, 0.0)) {
         outColor = vec4(0.0);
+        outDepth = 1.0e3;
         return;
     }
 
+    // Steps follow the tolerance: dt0 is the step in translucent space near visible density, refined to a
+    // quarter of it at opacity gradients and grown to four times it where little can still change.
+    float dt0 = clamp(0.5 * uTolerance, 0.001, 0.05);
+    float dtMin = 0.25 * dt0;
+    float dtMax = 4.0 * dt0;
+    float dt = dt0;
+
     float t = max(entry, 0.0);
-    if (uEnableJitter == 1) {
-        t += (RandomJitter(gl_FragCoord.xy, uJitterSeed) - 0.5) * uStepSize;
-    }
+#if ENABLE_JITTER
+    t += RandomJitter(gl_FragCoord.xy, uJitterSeed) * dt0;
+#endif
 
     vec3 accumColor = vec3(0.0);
     float accumAlpha = 0.0;
+    float accumDepth = 0.0;  // distance weighted by marched contributions; blank haze has no depth
+    float depthWeight = 0.0;
     bool earlyExit = false;
     int steps = 0;
+    float marched = 0.0;
+    float skipped = 0.0;
+    float alphaPrev = -1.0; // below zero after a leap: the next sample starts a fresh run
+    float densityPrev = 0.0;
+    float tPrev = t;
+    vec3 volumeExtent = uVolumeMax - uVolumeMin;
 
-    for (int i = 0; i < uMaxSteps; ++i) {
-        float sampleT = t + float(i) * uStepSize;
-        if (sampleT > exit) {
+    // The pulse decays over a fixed time rather than a fixed share of the beat, so slow tempi keep a
+    // sharp kick instead of a long swell (it matches exp(-8 * phase) at 120 BPM).
+    float beatSeconds = uBpm > 0.0 ? 60.0 / uBpm : 0.5;
+    float beatPulse = uBeatConfidence * exp(-uBeatPhase * beatSeconds / kBeatPulseSeconds);
+
+    // Skipped space reads only the first LUT texel, so a stretch of it composites in closed form.
+    vec4 blankTexel = texelFetch(uTransferLut, ivec2(0), 0);
+#if COLOR_MODE == 0
+    vec3 blankColor = vec3(0.0);
+#else
+    vec3 blankColor = blankTexel.rgb;
+#endif
+    float blankAlpha = clamp(blankTexel.a * uAlphaScale, 0.0, 1.0);
+
+    int shellTotal = min(shellCount, kMaxShells);
+    int spanCount = uShellClipping == 1 ? 2 * shellTotal : 1;
+    int spanIndex = -1;
+    vec2 span = vec2(-1.0e3);
+
+    for (int n = 0; n < kMaxSamples; ++n) {
+        // Move on to the segment holding this sample.
+        while (spanIndex < spanCount && t > span.y) {
+            float resume = exit;
+            if (++spanIndex < spanCount) {
+                span = RaySpan(spanIndex, shellTotal, uCameraPos, rayDir, t, exit);
+                resume = clamp(span.x, t, exit);
+            }
+            CompositeBlank(resume - t, blankColor, blankAlpha, accumColor, accumAlpha, earlyExit);
+            skipped += resume - t;
+            t = resume;
+            alphaPrev = -1.0;
+        }
+        if (earlyExit || spanIndex >= spanCount || t > exit) {
             break;
         }
 
-        vec3 samplePos = uCameraPos + rayDir * sampleT;
+        vec3 samplePos = uCameraPos + rayDir * t;
+        ivec3 brick = clamp(ivec3(floor((samplePos - uVolumeMin) / volumeExtent * uBricksPerUnit)), ivec3(0), ivec3(uBrickGrid - 1));
+        vec2 range = texelFetch(uBrickTex, brick, 0).rg;
+        bool blank = range.y <= uEmptyRange.x;
+        if (uEnableSkipping == 1 && (blank || range.x >= uEmptyRange.y)) {
+            // Leap past the brick's far faces, or to the end of the segment.
+            vec3 brickMin = uVolumeMin + vec3(brick) / uBricksPerUnit * volumeExtent;
+            vec3 brickMax = brickMin + volumeExtent / uBricksPerUnit;
+            vec3 far = (mix(brickMin, brickMax, step(0.0, rayDir)) - uCameraPos) * invDir;
+            float next = min(min(min(far.x, far.y), far.z), span.y) + 1.0e-4;
+            if (blank) {
+                CompositeBlank(next - t, blankColor, blankAlpha, accumColor, accumAlpha, earlyExit);
+                if (earlyExit) {
+                    break;
+                }
+            }
+            skipped += next - t;
+            t = next;
+            alphaPrev = -1.0;
+            continue;
+        }
+
         vec3 normalizedPos = samplePos;
         float radialLen = length(normalizedPos);
         vec3 radialDir = radialLen > 1e-5 ? normalizedPos / radialLen : vec3(0.0);
         vec3 warpedPos = normalizedPos;
-        if (uShellMode == 0) {
-            float ripple = uRippleAmp * uBass * sin(uRippleFreq * radialLen + uTime * uRippleSpeed);
-            warpedPos += radialDir * ripple;
-        } else {
-            float noise = Noise3(normalizedPos * uNoiseFreq + vec3(uTime * uNoiseSpeed));
-            float warp = uNoiseStrength * uBass * (noise * 2.0 - 1.0);
-            warpedPos += radialDir * warp;
-        }
+#if SHELL_MODE == 0
+        // Spectral flux stirs the ripple; a brighter spectrum (higher centroid) packs the wave fronts tighter.
+        float rippleDrive = uBass + 0.5 * uOnsetPulse.x + 0.5 * beatPulse + 0.5 * uSpectralMotion.x;
+        float ripple = uRippleAmp * rippleDrive * sin(uRippleFreq * (1.0 + 0.5 * uSpectralShape.x) * radialLen + uTime * uRippleSpeed);
+        warpedPos += radialDir * ripple;
+#else
+        float noise = Noise3(normalizedPos * uNoiseFreq + vec3(uTime * uNoiseSpeed));
+        float warp = uNoiseStrength * uBass * (noise * 2.0 - 1.0);
+        warpedPos += radialDir * warp;
+#endif
         warpedPos = clamp(warpedPos, uVolumeMin, uVolumeMax);
         vec3 texCoord = (warpedPos - uVolumeMin) / (uVolumeMax - uVolumeMin);
         if (any(lessThan(texCoord, vec3(0.0))) || any(greaterThan(texCoord, vec3(1.0)))) {
+            t += dt;
             continue;
         }
 
         float density = texture(uVolumeTex, texCoord).r;
-        vec4 lutSample = texture(uTransferLut, vec2(density, 0.5));
-        vec3 color = (uColorMode == 0)
-            ? vec3(density)
-            : lutSample.rgb;
-        float alpha = clamp(lutSample.a * uAlphaScale, 0.0, 1.0);
+        vec4 lutSample;
+        float segment = 0.0; // pre-integrated: the stretch back to the previous sample, none after a leap
+        if (uPreintegrated == 1) {
+            densityPrev = alphaPrev < 0.0 ? density : densityPrev;
+            segment = alphaPrev < 0.0 ? 0.0 : t - tPrev;
+            lutSample = texture(uPreintegratedLut, vec2(densityPrev, density));
+        } else {
+            lutSample = texture(uTransferLut, vec2(density, 0.5));
+        }
+#if COLOR_MODE == 0
+        vec3 color = vec3(uPreintegrated == 1 ? 0.5 * (densityPrev + density) : density);
+#else
+        vec3 color = lutSample.rgb;
+#endif
+        if (uSpectrogramEcho > 0.0) {
+            // Spectral history echoes outwards: the centre shows the newest row, the volume corners the
+            // oldest, and the polar angle picks the frequency bin.
+            float rows = float(textureSize(uSpectrogramTex, 0).y);
+            float age = clamp(radialLen / length(uVolumeMax), 0.0, 1.0);
+            float v = uSpectrogramOffset + clamp(1.0 - age, 0.5 / rows, 1.0 - 0.5 / rows);
+            float bin = acos(clamp(radialDir.y, -1.0, 1.0)) / 3.14159265;
+            color *= 1.0 + uSpectrogramEcho * texture(uSpectrogramTex, vec2(bin, v)).r;
+        }
+        float opacity = clamp(lutSample.a * uAlphaScale, 0.0, 1.0); // per kReferenceStep
+        densityPrev = density;
+        tPrev = t;
+
+        // The opacity change since the last sample, weighted by what can still show through, sets the next step.
+        float error = alphaPrev < 0.0 ? uTolerance : (1.0 - accumAlpha) * abs(opacity - alphaPrev);
+        alphaPrev = opacity;
+        float cap = range.y > uEmptyRange.x ? min(dtMax, dt0 / max(1.0 - accumAlpha, 0.25)) : dtMax;
+        dt = clamp(dt * clamp(sqrt(uTolerance / max(error, 1.0e-6)), 0.5, 2.0), dtMin, cap);
+        dt = min(dt, max(span.y - t, dtMin));
+        // A point sample stands for the step ahead of it; a pre-integrated one for the segment behind.
+        float alpha = 1.0 - pow(1.0 - opacity, (uPreintegrated == 1 ? segment : dt) / kReferenceStep);
 
         accumColor += (1.0 - accumAlpha) * color * alpha;
+        accumDepth += (1.0 - accumAlpha) * alpha * t;
+        depthWeight += (1.0 - accumAlpha) * alpha;
         accumAlpha += (1.0 - accumAlpha) * alpha;
         steps++;
+        marched += dt;
+        t += dt;
 
         if (accumAlpha >= 0.98) {
             earlyExit = true;
@@ -139,10 +335,15 @@ void main() {
         }
     }
 
+#if ENABLE_STATS
     atomicAdd(totalSteps, uint(steps));
+    atomicAdd(skippedLength, uint(skipped / kReferenceStep + 0.5));
+    atomicAdd(marchedLength, uint(marched / kReferenceStep + 0.5));
     if (earlyExit) {
         atomicAdd(earlyExitCount, 1u);
     }
+#endif
 
     outColor = vec4(accumColor, accumAlpha);
+    outDepth = depthWeight > 1.0e-3 ? accumDepth / depthWeight : 1.0e3;
 }
@@ -0,0 +1,53 @@
+#version 430 core
+
+layout(location = 0) out vec4 outColor;
+
+uniform mat4 uInvViewProj;
+uniform mat4 uPrevViewProj; // view-projection the history was rendered with
+uniform vec3 uCameraPos;
+uniform vec2 uScreenSize;   // size of the volume targets
+uniform float uBlend;       // weight of the new frame
+uniform int uHistoryValid;
+layout(binding = 0) uniform sampler2D uCurrentColor;
+layout(binding = 1) uniform sampler2D uCurrentDepth; // alpha-weighted distance along the ray, far when empty
+layout(binding = 2) uniform sampler2D uHistory;
+
+void main() {
+    ivec2 texel = ivec2(gl_FragCoord.xy);
+    vec4 current = texelFetch(uCurrentColor, texel, 0);
+    if (uHistoryValid == 0) {
+        outColor = current;
+        return;
+    }
+
+    // The jitter noise of this frame spans the neighbourhood's range; history outside it is stale.
+    ivec2 texelMax = ivec2(uScreenSize) - 1;
+    vec4 lo = current;
+    vec4 hi = current;
+    for (int y = -1; y <= 1; ++y) {
+        for (int x = -1; x <= 1; ++x) {
+            vec4 neighbour = texelFetch(uCurrentColor, clamp(texel + ivec2(x, y), ivec2(0), texelMax), 0);
+            lo = min(lo, neighbour);
+            hi = max(hi, neighbour);
+        }
+    }
+
+    // Reproject the point the ray's colour mostly came from.
+    vec2 uv = gl_FragCoord.xy / uScreenSize;
+    vec4 world = uInvViewProj * vec4(uv * 2.0 - 1.0, -1.0, 1.0);
+    vec3 rayDir = normalize(world.xyz / world.w - uCameraPos);
+    float depth = texelFetch(uCurrentDepth, texel, 0).r;
+    vec4 prevClip = uPrevViewProj * vec4(uCameraPos + rayDir * depth, 1.0);
+    if (prevClip.w <= 0.0) {
+        outColor = current;
+        return;
+    }
+    vec2 prevUv = prevClip.xy / prevClip.w * 0.5 + 0.5;
+    if (any(lessThan(prevUv, vec2(0.0))) || any(greaterThan(prevUv, vec2(1.0)))) {
+        outColor = current;
+        return;
+    }
+
+    vec4 history = clamp(texture(uHistory, prevUv), lo, hi);
+    outColor = mix(history, current, uBlend);
+}
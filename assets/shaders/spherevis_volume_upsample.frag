@@ -0,0 +1,75 @@
+#version 430 core
+
+layout(location = 0) out vec4 outColor;
+
+uniform mat4 uInvViewProj;
+uniform vec3 uCameraPos;
+uniform vec2 uScreenSize;     // full resolution
+uniform vec2 uLowSize;        // resolution the volume was marched at
+uniform float uContentRadius; // sphere holding every visible shell, padded like the shell intervals
+layout(binding = 0) uniform sampler2D uLowColor;
+layout(binding = 1) uniform sampler2D uLowDepth; // alpha-weighted distance along the ray, far when empty
+
+const float kFar = 1.0e3;
+const float kGuideSigma = 0.02; // world units; the guide is exact, so only numerical noise needs tolerance
+const float kDepthSigma = 0.1;
+
+vec3 RayDirection(vec2 uv) {
+    vec4 world = uInvViewProj * vec4(uv * 2.0 - 1.0, -1.0, 1.0);
+    return normalize(world.xyz / world.w - uCameraPos);
+}
+
+// Distance to where the ray enters the content sphere: cheap enough to evaluate per full-resolution
+// pixel, and it jumps exactly at the shells' silhouette, which is where plain bilinear upsampling blurs.
+float GuideDepth(vec2 uv) {
+    vec3 dir = RayDirection(uv);
+    float b = dot(uCameraPos, dir);
+    float c = dot(uCameraPos, uCameraPos) - uContentRadius * uContentRadius;
+    float h = b * b - c;
+    if (h < 0.0) {
+        return kFar;
+    }
+    float sq = sqrt(h);
+    return -b + sq < 0.0 ? kFar : max(-b - sq, 0.0);
+}
+
+void main() {
+    vec2 uv = gl_FragCoord.xy / uScreenSize;
+    float guide = GuideDepth(uv);
+
+    vec2 lowCoord = uv * uLowSize - 0.5;
+    ivec2 base = ivec2(floor(lowCoord));
+    vec2 f = lowCoord - vec2(base);
+    ivec2 lowMax = ivec2(uLowSize) - 1;
+
+    // The low-resolution texel nearest in guide depth sets the reference for the stored depths, so a
+    // shell seen through another does not bleed into it either.
+    ivec2 texels[4];
+    float guides[4];
+    float depths[4];
+    float bilinear[4];
+    int reference = 0;
+    for (int i = 0; i < 4; ++i) {
+        ivec2 offset = ivec2(i & 1, i >> 1);
+        texels[i] = clamp(base + offset, ivec2(0), lowMax);
+        guides[i] = GuideDepth((vec2(texels[i]) + 0.5) / uLowSize);
+        depths[i] = texelFetch(uLowDepth, texels[i], 0).r;
+        vec2 w = mix(1.0 - f, f, vec2(offset));
+        bilinear[i] = w.x * w.y;
+        if (abs(guides[i] - guide) < abs(guides[reference] - guide)
+            || (abs(guides[i] - guide) == abs(guides[reference] - guide) && bilinear[i] > bilinear[reference])) {
+            reference = i;
+        }
+    }
+
+    vec4 sum = vec4(0.0);
+    float weightSum = 0.0;
+    for (int i = 0; i < 4; ++i) {
+        float w = bilinear[i]
+            * exp(-abs(guides[i] - guide) / kGuideSigma)
+            * exp(-abs(depths[i] - depths[reference]) / kDepthSigma);
+        sum += w * texelFetch(uLowColor, texels[i], 0);
+        weightSum += w;
+    }
+    outColor = weightSum > 1.0e-4 ? sum / weightSum : texelFetch(uLowColor, texels[reference], 0);
+}
@@ -50,22 +50,23 @@ static void kf_bfly2(kiss_fft_cpx * Fout, const size_t fstride, const kiss_fft_c
 }
 
 static void kf_bfly4(kiss_fft_cpx * Fout, const size_t fstride, const kiss_fft_cfg st, int m) {
-    const kiss_fft_cpx * tw1 = st->twiddles;
-    const kiss_fft_cpx * tw2 = st->twiddles + fstride;
-    const kiss_fft_cpx * tw3 = st->twiddles + 2 * fstride;
+    const kiss_fft_cpx * twiddles = st->twiddles;
     kiss_fft_cpx scratch[6];
     for (int i = 0; i < m; ++i) {
         kiss_fft_cpx * Fout0 = Fout + i;
         kiss_fft_cpx * Fout1 = Fout0 + m;
         kiss_fft_cpx * Fout2 = Fout0 + 2 * m;
         kiss_fft_cpx * Fout3 = Fout0 + 3 * m;
+        const kiss_fft_cpx * tw1 = twiddles + i * fstride;
+        const kiss_fft_cpx * tw2 = twiddles + 2 * i * fstride;
+        const kiss_fft_cpx * tw3 = twiddles + 3 * i * fstride;
 
-        scratch[0].r = Fout1->r * tw1[i * fstride].r - Fout1->i * tw1[i * fstride].i;
-        scratch[0].i = Fout1->r * tw1[i * fstride].i + Fout1->i * tw1[i * fstride].r;
-        scratch[1].r = Fout2->r * tw2[i * fstride].r - Fout2->i * tw2[i * fstride].i;
-        scratch[1].i = Fout2->r * tw2[i * fstride].i + Fout2->i * tw2[i * fstride].r;
-        scratch[2].r = Fout3->r * tw3[i * fstride].r - Fout3->i * tw3[i * fstride].i;
-        scratch[2].i = Fout3->r * tw3[i * fstride].i + Fout3->i * tw3[i * fstride].r;
+        scratch[0].r = Fout1->r * tw1->r - Fout1->i * tw1->i;
+        scratch[0].i = Fout1->r * tw1->i + Fout1->i * tw1->r;
+        scratch[1].r = Fout2->r * tw2->r - Fout2->i * tw2->i;
+        scratch[1].i = Fout2->r * tw2->i + Fout2->i * tw2->r;
+        scratch[2].r = Fout3->r * tw3->r - Fout3->i * tw3->i;
+        scratch[2].i = Fout3->r * tw3->i + Fout3->i * tw3->r;
 
         scratch[5].r = Fout0->r - scratch[1].r;
         scratch[5].i = Fout0->i - scratch[1].i;
@@ -89,18 +90,19 @@ static void kf_bfly4(kiss_fft_cpx * Fout, const size_t fstride, const kiss_fft_c
 static void kf_bfly3(kiss_fft_cpx * Fout, const size_t fstride, const kiss_fft_cfg st, int m) {
     size_t k = m;
     size_t m2 = 2 * m;
-    const kiss_fft_cpx * tw1 = st->twiddles;
-    const kiss_fft_cpx * tw2 = st->twiddles + fstride;
+    const kiss_fft_cpx * twiddles = st->twiddles;
     kiss_fft_cpx scratch[5];
     for (size_t i = 0; i < k; ++i) {
         kiss_fft_cpx * Fout0 = Fout + i;
         kiss_fft_cpx * Fout1 = Fout0 + k;
         kiss_fft_cpx * Fout2 = Fout0 + m2;
+        const kiss_fft_cpx * tw1 = twiddles + i * fstride;
+        const kiss_fft_cpx * tw2 = twiddles + 2 * i * fstride;
 
-        scratch[1].r = Fout1->r * tw1[i * fstride].r - Fout1->i * tw1[i * fstride].i;
-        scratch[1].i = Fout1->r * tw1[i * fstride].i + Fout1->i * tw1[i * fstride].r;
-        scratch[2].r = Fout2->r * tw2[i * fstride].r - Fout2->i * tw2[i * fstride].i;
-        scratch[2].i = Fout2->r * tw2[i * fstride].i + Fout2->i * tw2[i * fstride].r;
+        scratch[1].r = Fout1->r * tw1->r - Fout1->i * tw1->i;
+        scratch[1].i = Fout1->r * tw1->i + Fout1->i * tw1->r;
+        scratch[2].r = Fout2->r * tw2->r - Fout2->i * tw2->i;
+        scratch[2].i = Fout2->r * tw2->i + Fout2->i * tw2->r;
 
         scratch[3].r = scratch[1].r + scratch[2].r;
         scratch[3].i = scratch[1].i + scratch[2].i;
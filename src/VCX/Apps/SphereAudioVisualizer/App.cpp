@@ -31,6 +31,7 @@
 
 #include "Assets/bundled.h"
 #include "Engine/app.h"
+#include "Engine/loader.h"
 #include "Engine/math.hpp"
 #include "Engine/GL/Sampler.hpp"
 #include "Engine/GL/Texture.hpp"
@@ -55,11 +56,52 @@ namespace VCX::Apps::SphereAudioVisualizer {
         constexpr glm::vec3 kVolumeMin { -1.f };
         constexpr glm::vec3 kVolumeMax {  1.f };
         constexpr std::size_t kTransferLutSize = 256;
+        constexpr float kBrickDensityMargin = 1.f / 256.f; // covers R8 and half-float rounding of the volume
+        constexpr char const * kBlueNoisePath = "assets/images/bluenoise-256x256.png";
+        constexpr double kGoldenRatioConjugate = 0.6180339887498949;
+        constexpr float kHistoryCameraJump = 0.1f;  // eye travel per frame, relative to its distance to the target
+        constexpr float kHistoryEnergyJump = 0.25f; // change of the average normalised band energy per frame
+        constexpr float kBeatPulseSeconds = 0.0625f; // beat pulse decay time, as in spherevis_volume.frag
+        constexpr float kBlankDensityTexels = 0.45f;        // below this, in LUT texels, R8 stores 0 and half floats stay under the first texel centre
+        constexpr float kOnsetPulseDecay = 0.12f;       // seconds for the onset pulse to fall to 1/e
+        constexpr std::size_t kMaxOnsetHopsPerFrame = 64; // older backlog is skipped after a stall
+        constexpr std::uint64_t kMaxTapBacklog = 16384; // samples; the sliding DFT restarts after a longer stall
+        constexpr float kLoudnessToBandMagnitude = 0.3536f; // a tone of RMS r reads r * sqrt(2) / 4 per band (Hann, |X| / N)
+        constexpr std::size_t kSpectrogramRows = 256; // analysis frames of history, about 4 s at 60 Hz
+        // Rotate a colour about the grey axis, which turns its hue and keeps its luma roughly.
+        glm::vec3 RotateHue(glm::vec3 const & color, float turns) {
+            if (turns == 0.f) return color;
+            float const angle = turns * glm::two_pi<float>();
+            glm::vec3 const axis(0.57735027f);
+            float const c = std::cos(angle);
+            float const s = std::sin(angle);
+            glm::vec3 const rotated = color * c + glm::cross(axis, color) * s + axis * glm::dot(axis, color) * (1.f - c);
+            return glm::clamp(rotated, glm::vec3(0.f), glm::vec3(1.f));
+        }
+
+        float AverageRange(std::vector<float> const & values, std::size_t begin, std::size_t end) {
+            if (end <= begin || end > values.size()) return 0.f;
+            return std::accumulate(values.begin() + static_cast<std::ptrdiff_t>(begin), values.begin() + static_cast<std::ptrdiff_t>(end), 0.f)
+                / static_cast<float>(end - begin);
+        }
+
+        // Config keys and labels of App::ModulationTarget, in enum order.
+        constexpr std::array<char const *, 6> kModulationTargetKeys { "noiseStrength", "noiseFreq", "noiseSpeed", "rippleAmp", "rippleFreq", "rippleSpeed" };
+        constexpr std::array<char const *, 6> kModulationTargetLabels { "Noise Strength", "Noise Frequency", "Noise Speed", "Ripple Amplitude", "Ripple Frequency", "Ripple Speed" };
 
         struct StatsData {
             uint32_t Steps     = 0;
             uint32_t Rays      = 0;
             uint32_t EarlyExit = 0;
+            uint32_t Skipped   = 0; // ray length in reference steps
+            uint32_t Marched   = 0;
+        };
+
+        // std430 layout of the raymarcher's ShellIntervals buffer.
+        struct ShellIntervalData {
+            std::int32_t Count = 0;
+            std::int32_t Padding = 0;
+            std::array<SphereVolumeData::ShellInterval, SphereVolumeData::kMaxShellIntervals> Intervals {};
         };
 
         std::filesystem::path ResolveLogPath() {
@@ -111,8 +153,8 @@ namespace VCX::Apps::SphereAudioVisualizer {
             return true;
         }
 
-        int ClampFftIndex(int idx) {
-            return std::clamp(idx, 0, static_cast<int>(App::kFftSizes.size()) - 1);
+        int ClampResolutionDivisor(int divisor) {
+            return divisor >= 4 ? 4 : (divisor >= 2 ? 2 : 1);
         }
 
         void LogIfSlow(char const * label, float ms, float thresholdMs, float currentTime) {
@@ -123,172 +165,6 @@ namespace VCX::Apps::SphereAudioVisualizer {
             }
         }
 
-        int CurrentFftSize(App::AudioAnalysisSettings const & settings) {
-            return App::kFftSizes[ClampFftIndex(settings.FftSizeIndex)];
-        }
-
-        void BuildWindowCoeffs(std::vector<float> & coeffs, int fftSize, App::WindowType type) {
-            coeffs.resize(static_cast<std::size_t>(fftSize));
-            if (fftSize <= 1) {
-                std::fill(coeffs.begin(), coeffs.end(), 1.f);
-                return;
-            }
-            float denom = static_cast<float>(fftSize - 1);
-            float twoPi = 6.28318530718f;
-            for (int i = 0; i < fftSize; ++i) {
-                float phase = twoPi * static_cast<float>(i) / denom;
-                switch (type) {
-                case App::WindowType::Hamming:
-                    coeffs[static_cast<std::size_t>(i)] = 0.54f - 0.46f * std::cos(phase);
-                    break;
-                case App::WindowType::Hann:
-                default:
-                    coeffs[static_cast<std::size_t>(i)] = 0.5f * (1.f - std::cos(phase));
-                    break;
-                }
-            }
-        }
-
-        void ApplyWindow(std::vector<float> const & coeffs, std::vector<float> & samples, int fftSize) {
-            if (coeffs.size() < static_cast<std::size_t>(fftSize) || samples.size() < static_cast<std::size_t>(fftSize))
-                return;
-            for (int i = 0; i < fftSize; ++i) {
-                samples[static_cast<std::size_t>(i)] *= coeffs[static_cast<std::size_t>(i)];
-            }
-        }
-
-        void DownsampleSpectrum(std::vector<float> const & src, std::vector<float> & dst, std::size_t target) {
-            if (target == 0 || src.empty()) {
-                dst.clear();
-                return;
-            }
-            dst.assign(target, 0.f);
-            float step = static_cast<float>(src.size()) / static_cast<float>(target);
-            for (std::size_t i = 0; i < target; ++i) {
-                std::size_t start = static_cast<std::size_t>(std::floor(step * i));
-                std::size_t end = static_cast<std::size_t>(std::floor(step * (i + 1)));
-                end = std::min(end, src.size());
-                start = std::min(start, src.size());
-                if (end <= start) continue;
-                float sum = 0.f;
-                for (std::size_t j = start; j < end; ++j) {
-                    sum += src[j];
-                }
-                dst[i] = sum / static_cast<float>(end - start);
-            }
-        }
-
-        struct BandRange {
-            int Start;
-            int End; // exclusive
-        };
-
-        BandRange ComputeBandRange(App::AudioAnalysisSettings const & settings, int bandIndex, int numBands, int fftSize, int sampleRate) {
-            int half = fftSize / 2;
-            if (half <= 1) return { 0, 1 };
-            bandIndex = std::clamp(bandIndex, 0, numBands - 1);
-            if (settings.Mapping == App::MappingType::Linear) {
-                int start = static_cast<int>(std::floor(static_cast<float>(bandIndex) * half / numBands));
-                int end   = static_cast<int>(std::floor(static_cast<float>(bandIndex + 1) * half / numBands));
-                end = std::max(end, start + 1);
-                end = std::min(end, half);
-                return { start, end };
-            }
-
-            float nyquist = static_cast<float>(sampleRate) * 0.5f;
-            float fMin = std::max(settings.MinFrequency, 1.f);
-            float fMax = std::max(fMin, nyquist);
-            float logMin = std::log(fMin);
-            float logMax = std::log(fMax);
-            float t0 = static_cast<float>(bandIndex) / static_cast<float>(numBands);
-            float t1 = static_cast<float>(bandIndex + 1) / static_cast<float>(numBands);
-            float f0 = std::exp(logMin + (logMax - logMin) * t0);
-            float f1 = std::exp(logMin + (logMax - logMin) * t1);
-            int start = static_cast<int>(std::floor(f0 * static_cast<float>(fftSize) / static_cast<float>(sampleRate)));
-            int end   = static_cast<int>(std::ceil (f1 * static_cast<float>(fftSize) / static_cast<float>(sampleRate)));
-            start = std::clamp(start, 0, half - 1);
-            end   = std::clamp(end, start + 1, half);
-            return { start, end };
-        }
-
-        float AggregateBand(std::vector<float> const & spectrum, BandRange range, App::AggregateType agg) {
-            if (range.End <= range.Start || spectrum.empty()) return 0.f;
-            range.Start = std::clamp(range.Start, 0, static_cast<int>(spectrum.size()));
-            range.End = std::clamp(range.End, 0, static_cast<int>(spectrum.size()));
-            float value = 0.f;
-            if (agg == App::AggregateType::Max) {
-                for (int i = range.Start; i < range.End; ++i) {
-                    value = std::max(value, spectrum[static_cast<std::size_t>(i)]);
-                }
-            } else {
-                float sum = 0.f;
-                for (int i = range.Start; i < range.End; ++i) {
-                    sum += spectrum[static_cast<std::size_t>(i)];
-                }
-                value = sum / static_cast<float>(range.End - range.Start);
-            }
-            return value;
-        }
-
-        float ApplyCompression(float magnitude, float k) {
-            k = std::max(k, 0.f);
-            return std::log1p(k * magnitude);
-        }
-
-        float UpdateAgcGain(float currentGain, float level, App::AudioAnalysisSettings const & settings, float deltaTime) {
-            float target = (level > 1e-6f) ? settings.AgcTarget / level : settings.AgcMaxGain;
-            target = std::clamp(target, 1.f / settings.AgcMaxGain, settings.AgcMaxGain);
-            float tau = target > currentGain ? settings.AgcAttack : settings.AgcRelease;
-            tau = std::max(tau, 1e-3f);
-            float alpha = std::exp(-deltaTime / tau);
-            float updated = alpha * currentGain + (1.f - alpha) * target;
-            return std::clamp(updated, 1.f / settings.AgcMaxGain, settings.AgcMaxGain);
-        }
-
-        char const * WindowTypeName(App::WindowType type) {
-            switch (type) {
-            case App::WindowType::Hamming:
-                return "Hamming";
-            case App::WindowType::Hann:
-            default:
-                return "Hann";
-            }
-        }
-
-        bool TryParseWindowType(std::string const & value, App::WindowType & out) {
-            if (value == "Hamming") {
-                out = App::WindowType::Hamming;
-                return true;
-            }
-            if (value == "Hann") {
-                out = App::WindowType::Hann;
-                return true;
-            }
-            return false;
-        }
-
-        char const * MappingTypeName(App::MappingType type) {
-            switch (type) {
-            case App::MappingType::Log:
-                return "Log";
-            case App::MappingType::Linear:
-            default:
-                return "Linear";
-            }
-        }
-
-        bool TryParseMappingType(std::string const & value, App::MappingType & out) {
-            if (value == "Log") {
-                out = App::MappingType::Log;
-                return true;
-            }
-            if (value == "Linear") {
-                out = App::MappingType::Linear;
-                return true;
-            }
-            return false;
-        }
-
         std::string TransferPresetName(App::TransferPreset preset) {
             switch (preset) {
             case App::TransferPreset::Neon:
@@ -766,6 +642,59 @@ namespace VCX::Apps::SphereAudioVisualizer {
         return _bloomResourcesValid;
     }
 
+    bool App::EnsureVolumeTargets(glm::ivec2 const & size) {
+        if (size.x <= 0 || size.y <= 0) {
+            _volumeTargetsValid = false;
+            return false;
+        }
+        if (_volumeTargetsValid && size == _volumeLowSize && _volumeLowColor.Get() != 0 && _volumeLowDepth.Get() != 0 && _volumeLowFbo.Get() != 0) {
+            return true;
+        }
+        _volumeLowSize = size;
+        _historyValid = false;
+        if (_volumeLowColor.Get() == 0) {
+            _volumeLowColor = VCX::Engine::GL::UniqueTexture2D();
+        }
+        if (_volumeLowDepth.Get() == 0) {
+            _volumeLowDepth = VCX::Engine::GL::UniqueTexture2D();
+        }
+        if (_volumeLowFbo.Get() == 0) {
+            _volumeLowFbo = VCX::Engine::GL::UniqueFramebuffer();
+        }
+
+        // The upsample pass reads exact texels; only the history is resampled, by the reprojection.
+        auto configureTexture = [=](VCX::Engine::GL::UniqueTexture2D & texture, GLint internalFormat, GLenum format, GLint filter) {
+            auto const use = texture.Use();
+            glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, size.x, size.y, 0, format, GL_FLOAT, nullptr);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        };
+        configureTexture(_volumeLowColor, GL_RGBA16F, GL_RGBA, GL_NEAREST);
+        configureTexture(_volumeLowDepth, GL_R32F, GL_RED, GL_NEAREST);
+        for (auto & history : _volumeHistory) {
+            configureTexture(history, GL_RGBA16F, GL_RGBA, GL_LINEAR);
+        }
+
+        // Called mid-frame with the HDR target bound, which RenderVolume composites into afterwards.
+        GLint previousFbo = 0;
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &previousFbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, _volumeLowFbo.Get());
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _volumeLowColor.Get(), 0);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, GL_TEXTURE_2D, _volumeLowDepth.Get(), 0);
+        GLenum const drawBuffers[] { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1 };
+        glDrawBuffers(2, drawBuffers);
+        _volumeTargetsValid = ValidateFramebufferStatus("VolumeLow");
+        for (std::size_t i = 0; i < _volumeHistory.size(); ++i) {
+            glBindFramebuffer(GL_FRAMEBUFFER, _volumeHistoryFbo[i].Get());
+            glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _volumeHistory[i].Get(), 0);
+            _volumeTargetsValid = ValidateFramebufferStatus("VolumeHistory") && _volumeTargetsValid;
+        }
+        glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(previousFbo));
+        return _volumeTargetsValid;
+    }
+
     void App::RenderBloomPasses(glm::ivec2 const & size) {
         if (!_renderToggles.Bloom || !_bloomSettings.Enable || !_hdrFramebufferValid) {
             _bloomMs = 0.f;
@@ -861,16 +790,14 @@ namespace VCX::Apps::SphereAudioVisualizer {
         float brightnessBoost = std::max(0.f, _sparkSettings.BurstBrightnessBoost);
         if (_sparkSettings.Enable && _sparkSettings.EnableBurst && _burstCooldownTimer <= 0.f) {
             float threshold = std::clamp(_sparkSettings.BeatThreshold, 0.f, 2.f);
-            float rise = _audioBass - _prevBass;
-            bool risingEdge = rise > 0.015f;
-            if (risingEdge && _audioBass >= threshold) {
+            if (_bassOnsetPending && _sparkBass >= threshold) {
                 burstCount = std::clamp(_sparkSettings.BurstCount, 0, _sparkSettings.MaxParticles);
                 _burstCooldownTimer = std::max(0.01f, _sparkSettings.BurstCooldown);
             }
         }
-        _prevBass = _audioBass;
+        _bassOnsetPending = false;
 
-        _sparkSystem->Update(deltaTime, _audioBass, _audioTreble, _sparkSettings, burstCount, speedBoost, brightnessBoost);
+        _sparkSystem->Update(deltaTime, _sparkBass, _sparkTreble, _sparkSettings, burstCount, speedBoost, brightnessBoost);
     }
 
     void App::RenderSparks(glm::ivec2 const & size) {
@@ -992,11 +919,6 @@ namespace VCX::Apps::SphereAudioVisualizer {
             };
 
             updateString(root["lastAudioPath"], _audioPath);
-            if (_audioPath[0] != '\0') {
-                if (!_audio.LoadFile(_audioPath)) {
-                    spdlog::warn("Failed to load audio from config path {}", _audioPath);
-                }
-            }
 
             if (auto audioNode = root["audio"]) {
                 _audioLoop = audioNode["loop"].as<bool>(_audioLoop);
@@ -1006,34 +928,14 @@ namespace VCX::Apps::SphereAudioVisualizer {
             }
 
             if (auto analysisNode = root["analysis"]) {
-                if (auto fftNode = analysisNode["fftSize"]) {
-                    int const fftSize = fftNode.as<int>(CurrentFftSize(_analysisSettings));
-                    auto const iter = std::find(kFftSizes.begin(), kFftSizes.end(), fftSize);
-                    if (iter != kFftSizes.end()) {
-                        _analysisSettings.FftSizeIndex = static_cast<int>(std::distance(kFftSizes.begin(), iter));
-                    }
-                }
-                _analysisSettings.NumBands = analysisNode["numBands"].as<int>(_analysisSettings.NumBands);
-                _analysisSettings.NumBands = std::clamp(_analysisSettings.NumBands, 1, 256);
-                if (auto windowNode = analysisNode["windowType"]) {
-                    App::WindowType type;
-                    if (TryParseWindowType(windowNode.as<std::string>(), type)) {
-                        _analysisSettings.Window = type;
-                    }
-                }
-                if (auto mappingNode = analysisNode["mappingType"]) {
-                    App::MappingType mapping;
-                    if (TryParseMappingType(mappingNode.as<std::string>(), mapping)) {
-                        _analysisSettings.Mapping = mapping;
-                    }
-                }
-                _analysisSettings.CompressK = analysisNode["compressK"].as<float>(_analysisSettings.CompressK);
-                if (auto agcNode = analysisNode["agc"]) {
-                    _analysisSettings.AgcEnabled = agcNode["enabled"].as<bool>(_analysisSettings.AgcEnabled);
-                    _analysisSettings.AgcTarget = agcNode["target"].as<float>(_analysisSettings.AgcTarget);
-                    _analysisSettings.AgcAttack = agcNode["attack"].as<float>(_analysisSettings.AgcAttack);
-                    _analysisSettings.AgcRelease = agcNode["release"].as<float>(_analysisSettings.AgcRelease);
-                    _analysisSettings.AgcMaxGain = agcNode["maxGain"].as<float>(_analysisSettings.AgcMaxGain);
+                ReadAnalysisSettings(analysisNode, _analysisSettings);
+            }
+
+            // Loaded after the analysis settings so the offline feature timeline is built with them.
+            if (_audioPath[0] != '\0') {
+                _audio.SetFeatureSettings(_analysisSettings);
+                if (!_audio.LoadFile(_audioPath)) {
+                    spdlog::warn("Failed to load audio from config path {}", _audioPath);
                 }
             }
 
@@ -1043,6 +945,9 @@ namespace VCX::Apps::SphereAudioVisualizer {
                 settings.VolumeSize = std::clamp(settings.VolumeSize, std::size_t(32), std::size_t(256));
                 settings.AmpScale = volumeNode["ampScale"].as<float>(settings.AmpScale);
                 settings.ThicknessScale = volumeNode["thicknessScale"].as<float>(settings.ThicknessScale);
+                settings.StereoPan = volumeNode["stereoPan"].as<float>(settings.StereoPan);
+                settings.StereoWidth = volumeNode["stereoWidth"].as<float>(settings.StereoWidth);
+                settings.OnsetKick = volumeNode["onsetKick"].as<float>(settings.OnsetKick);
                 _volumeData.SetSettings(settings);
             }
 
@@ -1069,11 +974,17 @@ namespace VCX::Apps::SphereAudioVisualizer {
             }
 
             if (auto renderNode = root["render"]) {
-                _renderSettings.StepSize = renderNode["stepSize"].as<float>(_renderSettings.StepSize);
-                _renderSettings.MaxSteps = renderNode["maxSteps"].as<int>(_renderSettings.MaxSteps);
-                _renderSettings.MaxSteps = std::clamp(_renderSettings.MaxSteps, 16, 512);
+                _renderSettings.ErrorTolerance = renderNode["errorTolerance"].as<float>(_renderSettings.ErrorTolerance);
+                _renderSettings.ErrorTolerance = std::clamp(_renderSettings.ErrorTolerance, 0.002f, 0.1f);
                 _renderSettings.AlphaScale = renderNode["alphaScale"].as<float>(_renderSettings.AlphaScale);
                 _renderSettings.AlphaScale = std::clamp(_renderSettings.AlphaScale, 0.1f, 10.f);
+                _renderSettings.EmptySkipping = renderNode["emptySkipping"].as<bool>(_renderSettings.EmptySkipping);
+                _renderSettings.ShellClipping = renderNode["shellClipping"].as<bool>(_renderSettings.ShellClipping);
+                _renderSettings.Preintegrated = renderNode["preintegrated"].as<bool>(_renderSettings.Preintegrated);
+                _renderSettings.ResolutionDivisor = ClampResolutionDivisor(renderNode["resolutionDivisor"].as<int>(_renderSettings.ResolutionDivisor));
+                _renderSettings.TemporalAccumulation = renderNode["temporalAccumulation"].as<bool>(_renderSettings.TemporalAccumulation);
+                _renderSettings.TemporalBlend = std::clamp(renderNode["temporalBlend"].as<float>(_renderSettings.TemporalBlend), 0.02f, 1.f);
+                _renderSettings.SpectrogramEcho = std::clamp(renderNode["spectrogramEcho"].as<float>(_renderSettings.SpectrogramEcho), 0.f, 4.f);
             }
 
             if (auto dynamicNode = root["dynamic"]) {
@@ -1083,6 +994,20 @@ namespace VCX::Apps::SphereAudioVisualizer {
                 _dynamicSettings.RippleAmp = dynamicNode["rippleAmp"].as<float>(_dynamicSettings.RippleAmp);
                 _dynamicSettings.RippleFreq = dynamicNode["rippleFreq"].as<float>(_dynamicSettings.RippleFreq);
                 _dynamicSettings.RippleSpeed = dynamicNode["rippleSpeed"].as<float>(_dynamicSettings.RippleSpeed);
+                if (auto modulationNode = dynamicNode["modulation"]) {
+                    for (std::size_t i = 0; i < kModulationTargetKeys.size(); ++i) {
+                        auto routeNode = modulationNode[kModulationTargetKeys[i]];
+                        if (!routeNode) continue;
+                        auto & route = _dynamicSettings.Modulation[i];
+                        if (auto sourceNode = routeNode["source"]) {
+                            ModulationSource source;
+                            if (TryParseModulationSource(sourceNode.as<std::string>(), source)) {
+                                route.Source = source;
+                            }
+                        }
+                        route.Depth = std::clamp(routeNode["depth"].as<float>(route.Depth), -1.f, 4.f);
+                    }
+                }
             }
 
             if (auto transferNode = root["transferFunction"]) {
@@ -1096,6 +1021,8 @@ namespace VCX::Apps::SphereAudioVisualizer {
                 _transferSettings.HighThreshold = transferNode["highThreshold"].as<float>(_transferSettings.HighThreshold);
                 _transferSettings.Gamma = transferNode["gamma"].as<float>(_transferSettings.Gamma);
                 _transferSettings.OverallAlpha = transferNode["overallAlpha"].as<float>(_transferSettings.OverallAlpha);
+                _transferSettings.KeyHue = std::clamp(transferNode["keyHue"].as<float>(_transferSettings.KeyHue), 0.f, 1.f);
+                _transferSettings.PresetFromMode = transferNode["presetFromMode"].as<bool>(_transferSettings.PresetFromMode);
                 if (auto controlPoints = transferNode["controlPoints"]) {
                     for (std::size_t i = 0; i < _transferSettings.ControlPoints.size() && i < controlPoints.size(); ++i) {
                         auto & dst = _transferSettings.ControlPoints[i];
@@ -1136,26 +1063,16 @@ namespace VCX::Apps::SphereAudioVisualizer {
             audioNode["monoMixMode"] = _monoMixMode;
             root["audio"] = audioNode;
 
-            YAML::Node analysisNode;
-            analysisNode["fftSize"] = CurrentFftSize(_analysisSettings);
-            analysisNode["numBands"] = _analysisSettings.NumBands;
-            analysisNode["windowType"] = WindowTypeName(_analysisSettings.Window);
-            analysisNode["mappingType"] = MappingTypeName(_analysisSettings.Mapping);
-            analysisNode["compressK"] = _analysisSettings.CompressK;
-            YAML::Node agcNode;
-            agcNode["enabled"] = _analysisSettings.AgcEnabled;
-            agcNode["target"] = _analysisSettings.AgcTarget;
-            agcNode["attack"] = _analysisSettings.AgcAttack;
-            agcNode["release"] = _analysisSettings.AgcRelease;
-            agcNode["maxGain"] = _analysisSettings.AgcMaxGain;
-            analysisNode["agc"] = agcNode;
-            root["analysis"] = analysisNode;
+            root["analysis"] = WriteAnalysisSettings(_analysisSettings);
 
             YAML::Node volumeNode;
             auto const volumeSettings = _volumeData.GetSettings();
             volumeNode["volumeSize"] = static_cast<int>(volumeSettings.VolumeSize);
             volumeNode["ampScale"] = volumeSettings.AmpScale;
             volumeNode["thicknessScale"] = volumeSettings.ThicknessScale;
+            volumeNode["stereoPan"] = volumeSettings.StereoPan;
+            volumeNode["stereoWidth"] = volumeSettings.StereoWidth;
+            volumeNode["onsetKick"] = volumeSettings.OnsetKick;
             root["volume"] = volumeNode;
 
             YAML::Node cameraNode;
@@ -1189,9 +1106,15 @@ namespace VCX::Apps::SphereAudioVisualizer {
             root["background"] = backgroundNode;
 
             YAML::Node renderNode;
-            renderNode["stepSize"] = _renderSettings.StepSize;
-            renderNode["maxSteps"] = _renderSettings.MaxSteps;
+            renderNode["errorTolerance"] = _renderSettings.ErrorTolerance;
             renderNode["alphaScale"] = _renderSettings.AlphaScale;
+            renderNode["emptySkipping"] = _renderSettings.EmptySkipping;
+            renderNode["shellClipping"] = _renderSettings.ShellClipping;
+            renderNode["preintegrated"] = _renderSettings.Preintegrated;
+            renderNode["resolutionDivisor"] = _renderSettings.ResolutionDivisor;
+            renderNode["temporalAccumulation"] = _renderSettings.TemporalAccumulation;
+            renderNode["temporalBlend"] = _renderSettings.TemporalBlend;
+            renderNode["spectrogramEcho"] = _renderSettings.SpectrogramEcho;
             root["render"] = renderNode;
 
             YAML::Node dynamicNode;
@@ -1201,6 +1124,18 @@ namespace VCX::Apps::SphereAudioVisualizer {
             dynamicNode["rippleAmp"] = _dynamicSettings.RippleAmp;
             dynamicNode["rippleFreq"] = _dynamicSettings.RippleFreq;
             dynamicNode["rippleSpeed"] = _dynamicSettings.RippleSpeed;
+            YAML::Node modulationNode;
+            for (std::size_t i = 0; i < kModulationTargetKeys.size(); ++i) {
+                auto const & route = _dynamicSettings.Modulation[i];
+                if (route.Source == ModulationSource::None) continue;
+                YAML::Node routeNode;
+                routeNode["source"] = ModulationSourceName(route.Source);
+                routeNode["depth"] = route.Depth;
+                modulationNode[kModulationTargetKeys[i]] = routeNode;
+            }
+            if (modulationNode.size() > 0) {
+                dynamicNode["modulation"] = modulationNode;
+            }
             root["dynamic"] = dynamicNode;
 
             YAML::Node transferNode;
@@ -1209,6 +1144,8 @@ namespace VCX::Apps::SphereAudioVisualizer {
             transferNode["highThreshold"] = _transferSettings.HighThreshold;
             transferNode["gamma"] = _transferSettings.Gamma;
             transferNode["overallAlpha"] = _transferSettings.OverallAlpha;
+            transferNode["keyHue"] = _transferSettings.KeyHue;
+            transferNode["presetFromMode"] = _transferSettings.PresetFromMode;
             YAML::Node controlPoints;
             for (auto const & point : _transferSettings.ControlPoints) {
                 YAML::Node cp;
@@ -1243,9 +1180,9 @@ namespace VCX::Apps::SphereAudioVisualizer {
             VCX::Engine::GL::SharedShader("assets/shaders/spherevis_bg.vert"),
             VCX::Engine::GL::SharedShader("assets/shaders/spherevis_bg.frag"),
         }),
-        _volumeProgram({
-            VCX::Engine::GL::SharedShader("assets/shaders/spherevis_volume.vert"),
-            VCX::Engine::GL::SharedShader("assets/shaders/spherevis_volume.frag"),
+        _volumePrograms({
+            "assets/shaders/spherevis_volume.vert",
+            "assets/shaders/spherevis_volume.frag",
         }),
         _tonemapProgram({
             VCX::Engine::GL::SharedShader("assets/shaders/spherevis_tonemap.vert"),
@@ -1262,6 +1199,14 @@ namespace VCX::Apps::SphereAudioVisualizer {
         _sparkProgram({
             VCX::Engine::GL::SharedShader("assets/shaders/spherevis_sparks.vert"),
             VCX::Engine::GL::SharedShader("assets/shaders/spherevis_sparks.frag"),
+        }),
+        _volumeUpsampleProgram({
+            VCX::Engine::GL::SharedShader("assets/shaders/spherevis_tonemap.vert"),
+            VCX::Engine::GL::SharedShader("assets/shaders/spherevis_volume_upsample.frag"),
+        }),
+        _volumeTemporalProgram({
+            VCX::Engine::GL::SharedShader("assets/shaders/spherevis_tonemap.vert"),
+            VCX::Engine::GL::SharedShader("assets/shaders/spherevis_volume_temporal.frag"),
         }) {
         SetupLogger();
         InitGLCapabilities();
@@ -1270,6 +1215,8 @@ namespace VCX::Apps::SphereAudioVisualizer {
         LogShaderProgramCompilation(_bloomBrightProgram.Get(), "spherevis_bloom_bright");
         LogShaderProgramCompilation(_bloomBlurProgram.Get(), "spherevis_bloom_blur");
         LogShaderProgramCompilation(_sparkProgram.Get(), "spherevis_sparks");
+        LogShaderProgramCompilation(_volumeUpsampleProgram.Get(), "spherevis_volume_upsample");
+        LogShaderProgramCompilation(_volumeTemporalProgram.Get(), "spherevis_volume_temporal");
         _useGpuBuild = _computeSupported;
         _buildOnEnergyUpdate = true;
         spdlog::debug("SphereAudioVisualizer initialized.");
@@ -1309,6 +1256,11 @@ namespace VCX::Apps::SphereAudioVisualizer {
         glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
         ResetStatsBuffer();
 
+        glGenBuffers(1, &_shellBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, _shellBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(ShellIntervalData), nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
         GLboolean blendBefore = glIsEnabled(GL_BLEND);
         GLint prevSrcRgb = 0;
         GLint prevDstRgb = 0;
@@ -1326,11 +1278,32 @@ namespace VCX::Apps::SphereAudioVisualizer {
         _sparkSystem = std::make_unique<SparkParticleSystem>();
         _sparkSystem->EnsureCapacity(_sparkSettings.MaxParticles);
 
-        _volumeProgram.GetUniforms().SetByName("uVolumeTexture", 0);
         _transferLutTexture.SetUnit(1);
-        _volumeProgram.GetUniforms().SetByName("uTransferLut", 1);
+        auto const blueNoise = VCX::Engine::LoadImageGray(kBlueNoisePath);
+        _blueNoiseLoaded = blueNoise.GetSizeX() > 0 && blueNoise.GetSizeY() > 0;
+        if (_blueNoiseLoaded) {
+            _blueNoiseTexture.UpdateSampler({
+                VCX::Engine::GL::WrapMode::Repeat,
+                VCX::Engine::GL::WrapMode::Repeat,
+                VCX::Engine::GL::WrapMode::Repeat,
+                VCX::Engine::GL::FilterMode::Nearest,
+                VCX::Engine::GL::FilterMode::Nearest,
+            });
+            _blueNoiseTexture.Update(blueNoise);
+        } else {
+            spdlog::warn("Blue noise {} not found; ray jitter falls back to white noise", kBlueNoisePath);
+        }
+        _noiseTexture.UpdateSampler({
+            VCX::Engine::GL::WrapMode::Repeat,
+            VCX::Engine::GL::WrapMode::Repeat,
+            VCX::Engine::GL::WrapMode::Repeat,
+            VCX::Engine::GL::FilterMode::Linear,
+            VCX::Engine::GL::FilterMode::Linear,
+        });
+        _noiseTexture.Update(BuildTileableValueNoise(kNoiseTextureSize));
         _audio.SetMonoMixMode(_monoMixMode);
         LoadConfig();
+        PrebuildWindowCoeffs(_analysisSettings.KaiserBeta);
     }
 
     App::~App() {
@@ -1342,6 +1315,10 @@ namespace VCX::Apps::SphereAudioVisualizer {
             glDeleteBuffers(1, &_statsBuffer);
             _statsBuffer = 0;
         }
+        if (_shellBuffer) {
+            glDeleteBuffers(1, &_shellBuffer);
+            _shellBuffer = 0;
+        }
         if (_bloomTimeQuery) {
             glDeleteQueries(1, &_bloomTimeQuery);
             _bloomTimeQuery = 0;
@@ -1361,6 +1338,12 @@ namespace VCX::Apps::SphereAudioVisualizer {
         spdlog::info("{}={:.3f}", name, value);
     }
 
+    float App::ModulatedDynamic(ModulationTarget target, float base) const {
+        auto const & route = _dynamicSettings.Modulation[static_cast<std::size_t>(target)];
+        float const value = GetModulationValue(_analysisState.Descriptors, route.Source);
+        return std::max(0.f, base * (1.f + route.Depth * value));
+    }
+
     void App::RenderAudioUI() {
         ImGui::Separator();
         if (ImGui::CollapsingHeader("Audio", ImGuiTreeNodeFlags_DefaultOpen)) {
@@ -1368,6 +1351,7 @@ namespace VCX::Apps::SphereAudioVisualizer {
             ImGui::InputText("File", _audioPath, IM_ARRAYSIZE(_audioPath));
             ImGui::SameLine();
             if (ImGui::Button("Load")) {
+                _audio.SetFeatureSettings(_analysisSettings);
                 bool ok = _audio.LoadFile(_audioPath);
                 if (ok) {
                     spdlog::info("Audio loaded: {}", _audioPath);
@@ -1414,11 +1398,15 @@ namespace VCX::Apps::SphereAudioVisualizer {
             ImGui::Text("Window RMS: %.5f", _audioWindowRms);
             ImGui::Text("FFT size: %d", _fftSize);
             ImGui::Text("FFT time: %.3f ms", _analysisState.LastFftMs);
+            auto const & descriptors = _analysisState.Descriptors;
+            ImGui::Text("Centroid %.3f  Rolloff %.3f  Flatness %.3f", descriptors.Centroid, descriptors.Rolloff, descriptors.Flatness);
+            ImGui::Text("Flux %.3f  Crest %.3f  ZCR %.3f  (%.3f ms)", descriptors.Flux, descriptors.Crest, descriptors.ZeroCrossing, _descriptorMs);
             ImGui::Text("Energies min/max/avg: %.3f / %.3f / %.3f",
                 _analysisState.EnergyMin,
                 _analysisState.EnergyMax,
                 _analysisState.EnergyAvg);
             ImGui::Text("AGC gain: %.3f", _analysisState.AgcGain);
+            ImGui::Text("Loudness: %.1f LUFS momentary, %.1f LUFS short-term", _loudnessMeter.GetMomentaryLufs(), _loudnessMeter.GetShortTermLufs());
             ImGui::PlotLines("Oscilloscope",
                 _oscilloscopePoints.data(),
                 static_cast<int>(_oscilloscopePoints.size()),
@@ -1447,12 +1435,39 @@ namespace VCX::Apps::SphereAudioVisualizer {
             if (ImGui::Combo("FFT Size", &_analysisSettings.FftSizeIndex, fftSizeLabels, IM_ARRAYSIZE(fftSizeLabels))) {
                 _analysisSettings.FftSizeIndex = ClampFftIndex(_analysisSettings.FftSizeIndex);
             }
+            ImGui::Checkbox("Multi-Resolution FFT", &_analysisSettings.MultiResolution);
+            if (_analysisSettings.MultiResolution) {
+                std::array<int, MultiResolutionSpectrum::kNumLevels> bandsPerLevel {};
+                for (std::size_t b = 0; b < _multiResSpectrum.GetNumBands(); ++b) {
+                    ++bandsPerLevel[static_cast<std::size_t>(_multiResSpectrum.GetBandLevel(b))];
+                }
+                for (std::size_t l = 0; l < MultiResolutionSpectrum::kNumLevels; ++l) {
+                    ImGui::Text("  %d-point: %d bands, %llu updates", MultiResolutionSpectrum::kSizes[l], bandsPerLevel[l],
+                        static_cast<unsigned long long>(_multiResSpectrum.GetUpdateCount(l)));
+                }
+            }
+            const char * slidingNames[] = { "Off", "On", "Auto" };
+            int slidingMode = static_cast<int>(_analysisSettings.SlidingDft);
+            if (ImGui::Combo("Sliding DFT", &slidingMode, slidingNames, IM_ARRAYSIZE(slidingNames))) {
+                _analysisSettings.SlidingDft = static_cast<SlidingDftMode>(slidingMode);
+            }
+            if (_analysisSettings.SlidingDft != SlidingDftMode::Off) {
+                bool const cheaper = SlidingDftSpectrum::PreferOverFft(_analysisSettings.NumBands, CurrentFftSize(_analysisSettings), CurrentFps(), _audio.GetSampleRate());
+                ImGui::Text("  %s, cheaper than FFT at %d bands: %s", _slidingDftActive ? "active" : "inactive", _analysisSettings.NumBands, cheaper ? "yes" : "no");
+                if (_slidingDftActive && _slidingDft.GetNumBands() > 0) {
+                    ImGui::Text("  window %zu (bass) .. %zu (treble) samples", _slidingDft.GetWindowLength(0),
+                        _slidingDft.GetWindowLength(_slidingDft.GetNumBands() - 1));
+                }
+            }
 
-            const char * windowNames[] = { "Hann", "Hamming" };
+            const char * windowNames[] = { "Hann", "Hamming", "Blackman-Harris", "Kaiser", "Flat-top" };
             int windowType = static_cast<int>(_analysisSettings.Window);
             if (ImGui::Combo("Window", &windowType, windowNames, IM_ARRAYSIZE(windowNames))) {
                 _analysisSettings.Window = static_cast<WindowType>(windowType);
             }
+            if (_analysisSettings.Window == WindowType::Kaiser) {
+                ImGui::SliderFloat("Kaiser Beta", &_analysisSettings.KaiserBeta, 0.f, kMaxKaiserBeta, "%.1f");
+            }
 
             const char * mappingNames[] = { "Linear", "Log" };
             int mappingType = static_cast<int>(_analysisSettings.Mapping);
@@ -1476,14 +1491,118 @@ namespace VCX::Apps::SphereAudioVisualizer {
             ImGui::SliderFloat("Compress k", &_analysisSettings.CompressK, 0.f, 32.f);
             ImGui::Checkbox("Show Spectrum", &_analysisSettings.ShowSpectrum);
 
+            const char * normalizationNames[] = { "AGC", "Quantile (per band)" };
+            int normalization = static_cast<int>(_analysisSettings.Normalization);
+            if (ImGui::Combo("Normalization", &normalization, normalizationNames, IM_ARRAYSIZE(normalizationNames))) {
+                _analysisSettings.Normalization = static_cast<BandNormalization>(normalization);
+            }
+            bool const quantileMode = _analysisSettings.Normalization == BandNormalization::Quantile;
+            if (quantileMode) {
+                ImGui::SliderFloat("Quantile Low", &_analysisSettings.QuantileLow, 0.f, 0.45f);
+                ImGui::SliderFloat("Quantile High", &_analysisSettings.QuantileHigh, 0.55f, 1.f);
+                ImGui::SliderFloat("Quantile Window (s)", &_analysisSettings.QuantileWindow, 1.f, 60.f);
+            }
+            ImGui::BeginDisabled(quantileMode);
             bool agcEnabled = _analysisSettings.AgcEnabled;
             if (ImGui::Checkbox("AGC Enabled", &agcEnabled)) {
                 _analysisSettings.AgcEnabled = agcEnabled;
             }
+            const char * agcSourceNames[] = { "Peak Band", "Loudness (LUFS)" };
+            int agcSource = static_cast<int>(_analysisSettings.AgcLevelSource);
+            if (ImGui::Combo("AGC Source", &agcSource, agcSourceNames, IM_ARRAYSIZE(agcSourceNames))) {
+                _analysisSettings.AgcLevelSource = static_cast<AgcSource>(agcSource);
+            }
             ImGui::SliderFloat("AGC Target", &_analysisSettings.AgcTarget, 0.05f, 2.f);
             ImGui::SliderFloat("AGC Attack (s)", &_analysisSettings.AgcAttack, 0.01f, 1.f);
             ImGui::SliderFloat("AGC Release (s)", &_analysisSettings.AgcRelease, 0.05f, 2.f);
             ImGui::SliderFloat("AGC Max Gain", &_analysisSettings.AgcMaxGain, 1.f, 40.f);
+            ImGui::EndDisabled();
+
+            ImGui::Checkbox("Harmonic/Percussive Split", &_analysisSettings.HpssEnabled);
+            if (_analysisSettings.HpssEnabled) {
+                ImGui::SliderInt("HPSS Time Frames", &_analysisSettings.HpssTimeFrames, 3, 63);
+                ImGui::SliderInt("HPSS Freq Bins", &_analysisSettings.HpssFreqBins, 3, 63);
+                if (_hpssActive) {
+                    ImGui::Text("HPSS %.3f ms (budget %.2f ms at 1024 bins)", _hpssMs, HarmonicPercussiveSeparator::kBudgetMs);
+                } else {
+                    ImGui::Text("HPSS inactive: needs the live FFT spectrum");
+                }
+            }
+            ImGui::Checkbox("Stereo Pan/Width", &_analysisSettings.StereoEnabled);
+            if (_analysisSettings.StereoEnabled) {
+                if (_stereoActive) {
+                    ImGui::Text("Balance %+.2f (packed L+iR transform)", _analysisState.StereoBalance);
+                    ImGui::PlotHistogram("Width",
+                        _analysisState.BandWidth.data(),
+                        static_cast<int>(_analysisState.BandWidth.size()),
+                        0,
+                        nullptr,
+                        0.f,
+                        1.f,
+                        ImVec2(-1.f, 50.f));
+                } else {
+                    ImGui::Text("Stereo inactive: needs a two-channel source on the single-FFT path");
+                }
+            }
+            ImGui::Checkbox("Chroma / Key", &_analysisSettings.ChromaEnabled);
+            if (_analysisSettings.ChromaEnabled) {
+                ImGui::SliderInt("Key Interval (frames)", &_analysisSettings.ChromaKeyInterval, 1, 120);
+                ImGui::SliderFloat("Key Window (s)", &_analysisSettings.ChromaKeySeconds, 1.f, 30.f);
+                ImGui::PlotHistogram("Chroma",
+                    _analysisState.Chroma.data(),
+                    kPitchClasses,
+                    0,
+                    nullptr,
+                    0.f,
+                    1.f,
+                    ImVec2(-1.f, 50.f));
+                auto const & key = _analysisState.Key;
+                if (key.Valid) {
+                    ImGui::Text("Key: %s %s (%.2f), %zu bins mapped", PitchClassName(key.Tonic), key.Minor ? "minor" : "major", key.Confidence, _chroma.GetMappedBins());
+                } else {
+                    ImGui::Text("Key: listening...");
+                }
+            }
+
+            ImGui::SliderFloat("Attack Low (s)", &_analysisSettings.EnvelopeAttackLow, 0.001f, 0.5f, "%.3f");
+            ImGui::SliderFloat("Attack High (s)", &_analysisSettings.EnvelopeAttackHigh, 0.001f, 0.5f, "%.3f");
+            ImGui::SliderFloat("Release Low (s)", &_analysisSettings.EnvelopeReleaseLow, 0.01f, 2.f);
+            ImGui::SliderFloat("Release High (s)", &_analysisSettings.EnvelopeReleaseHigh, 0.01f, 2.f);
+            ImGui::Checkbox("Peak Hold", &_analysisSettings.PeakHold);
+            ImGui::BeginDisabled(!_analysisSettings.PeakHold);
+            ImGui::SliderFloat("Hold (s)", &_analysisSettings.PeakHoldSeconds, 0.f, 1.f);
+            ImGui::SliderFloat("Peak Decay (s)", &_analysisSettings.PeakDecaySeconds, 0.01f, 2.f);
+            ImGui::EndDisabled();
+
+            ImGui::Checkbox("Onset Detection", &_analysisSettings.OnsetEnabled);
+            ImGui::SliderFloat("Onset Sensitivity", &_analysisSettings.OnsetSensitivity, 1.f, 4.f);
+            ImGui::SliderFloat("Onset Min Interval (s)", &_analysisSettings.OnsetMinInterval, 0.02f, 0.5f);
+            ImGui::Text("Onset flux L %.3f / %.3f  M %.3f / %.3f  H %.3f / %.3f",
+                _onsetDetector.GetFlux(OnsetDetector::Group::Low),
+                _onsetDetector.GetThreshold(OnsetDetector::Group::Low),
+                _onsetDetector.GetFlux(OnsetDetector::Group::Mid),
+                _onsetDetector.GetThreshold(OnsetDetector::Group::Mid),
+                _onsetDetector.GetFlux(OnsetDetector::Group::High),
+                _onsetDetector.GetThreshold(OnsetDetector::Group::High));
+            ImGui::Text("Onsets/s: %zu", _onsetsPerSecond);
+            ImGui::SliderFloat("Tempo Prior (BPM)", &_analysisSettings.TempoPriorBpm, 60.f, 200.f);
+            ImGui::Text("Tempo %.1f BPM, phase %.2f, confidence %.2f",
+                _tempoTracker.GetBpm(),
+                _tempoTracker.GetBeatPhase(),
+                _tempoTracker.GetConfidence());
+
+            ImGui::Checkbox("Use Feature Timeline", &_analysisSettings.UseFeatureTimeline);
+            ImGui::SliderFloat("Lookahead (s)", &_analysisSettings.LookaheadSeconds, 0.5f, 8.f);
+            auto const & timeline = _audio.GetFeatureTimeline();
+            if (_audio.IsFeatureJobRunning()) {
+                ImGui::Text("Timeline: analysing %.0f%%", _audio.GetFeatureProgress() * 100.f);
+            } else if (_featureTimelineActive) {
+                ImGui::Text("Timeline: %zu frames, frame %zu, anticipation %.2f", timeline.GetNumFrames(), _featureFrame, _anticipation);
+            } else if (!_audio.GetFeatureError().empty()) {
+                ImGui::Text("Timeline: %s (live FFT)", _audio.GetFeatureError().c_str());
+            } else {
+                ImGui::Text("Timeline: inactive (live FFT)");
+            }
 
             if (!_analysisState.BandEnergies.empty()) {
                 ImGui::PlotHistogram("Energies",
@@ -1495,6 +1614,24 @@ namespace VCX::Apps::SphereAudioVisualizer {
                     1.f,
                     ImVec2(-1.f, 120.f));
             }
+            if (_hpssActive && !_analysisState.HarmonicBands.empty()) {
+                ImGui::PlotHistogram("Harmonic",
+                    _analysisState.HarmonicBands.data(),
+                    static_cast<int>(_analysisState.HarmonicBands.size()),
+                    0,
+                    nullptr,
+                    0.f,
+                    1.f,
+                    ImVec2(-1.f, 60.f));
+                ImGui::PlotHistogram("Percussive",
+                    _analysisState.PercussiveBands.data(),
+                    static_cast<int>(_analysisState.PercussiveBands.size()),
+                    0,
+                    nullptr,
+                    0.f,
+                    1.f,
+                    ImVec2(-1.f, 60.f));
+            }
             if (_analysisSettings.ShowSpectrum && !_analysisState.SpectrumDownsample.empty()) {
                 ImGui::PlotLines("Spectrum",
                     _analysisState.SpectrumDownsample.data(),
@@ -1505,6 +1642,17 @@ namespace VCX::Apps::SphereAudioVisualizer {
                     0.1f,
                     ImVec2(-1.f, 80.f));
             }
+            if (_analysisSettings.ShowSpectrum && _spectrogram.GetRows() > 0) {
+                // The texture repeats along v, so the wrap offset alone scrolls it: newest row on top.
+                float const offset = _spectrogram.GetWrapOffset();
+                auto const spectrogramSize = ImVec2(256.f, 160.f);
+                ImGui::Image(
+                    _spectrogramTexture.GetImTextureId(),
+                    spectrogramSize,
+                    ImVec2(0.f, offset + 1.f),
+                    ImVec2(1.f, offset));
+                ImGui::Text("Spectrogram: %zu x %zu, %zu row(s) uploaded", _spectrogram.GetBins(), _spectrogram.GetRows(), _spectrogramTexture.GetRowsUploadedLastSync());
+            }
         }
     }
 
@@ -1538,6 +1686,10 @@ namespace VCX::Apps::SphereAudioVisualizer {
         if (ImGui::SliderFloat("Overall Alpha", &_transferSettings.OverallAlpha, 0.f, 1.f)) {
             settingsChanged = true;
         }
+        if (ImGui::SliderFloat("Key Hue", &_transferSettings.KeyHue, 0.f, 1.f)) {
+            settingsChanged = true;
+        }
+        ImGui::Checkbox("Preset From Key Mode", &_transferSettings.PresetFromMode);
 
         for (int i = 0; i < static_cast<int>(_transferSettings.ControlPoints.size()); ++i) {
             auto & point = _transferSettings.ControlPoints[static_cast<std::size_t>(i)];
@@ -1610,6 +1762,7 @@ namespace VCX::Apps::SphereAudioVisualizer {
         float gamma = std::max(_transferSettings.Gamma, 0.01f);
         normalized = normalized > 0.f ? std::pow(normalized, gamma) : 0.f;
 
+        float const hueShift = _keyHue * std::clamp(_transferSettings.KeyHue, 0.f, 1.f);
         auto const & points = _transferSettings.ControlPoints;
         if (points.empty()) {
             return glm::vec4(normalized, normalized, normalized, normalized);
@@ -1618,13 +1771,13 @@ namespace VCX::Apps::SphereAudioVisualizer {
         auto const & first = points.front();
         if (normalized <= first.Position) {
             float alpha = std::clamp(first.Alpha * _transferSettings.OverallAlpha, 0.f, 1.f);
-            return glm::vec4(first.Color, alpha);
+            return glm::vec4(RotateHue(first.Color, hueShift), alpha);
         }
 
         auto const & last = points.back();
         if (normalized >= last.Position) {
             float alpha = std::clamp(last.Alpha * _transferSettings.OverallAlpha, 0.f, 1.f);
-            return glm::vec4(last.Color, alpha);
+            return glm::vec4(RotateHue(last.Color, hueShift), alpha);
         }
 
         for (std::size_t i = 1; i < points.size(); ++i) {
@@ -1636,20 +1789,53 @@ namespace VCX::Apps::SphereAudioVisualizer {
                 glm::vec3 color = glm::mix(lower.Color, upper.Color, t);
                 float alpha = glm::mix(lower.Alpha, upper.Alpha, t);
                 alpha = std::clamp(alpha * _transferSettings.OverallAlpha, 0.f, 1.f);
-                return glm::vec4(color, alpha);
+                return glm::vec4(RotateHue(color, hueShift), alpha);
             }
         }
 
         float alpha = std::clamp(last.Alpha * _transferSettings.OverallAlpha, 0.f, 1.f);
-        return glm::vec4(last.Color, alpha);
+        return glm::vec4(RotateHue(last.Color, hueShift), alpha);
+    }
+
+    void App::ApplyKeyToTransfer(KeyEstimate const & key) {
+        if (!key.Valid) return;
+        // Circle-of-fifths position, so related keys get nearby hues; a minor key takes its relative major's.
+        int const major = key.Minor ? key.Tonic + 3 : key.Tonic;
+        float const hue = static_cast<float>((major * 7) % kPitchClasses) / static_cast<float>(kPitchClasses);
+        if (hue != _keyHue) {
+            _keyHue = hue;
+            if (_transferSettings.KeyHue > 0.f) {
+                _transferDirty = true;
+            }
+        }
+        if (_transferSettings.PresetFromMode) {
+            auto const preset = key.Minor ? TransferPreset::Smoke : TransferPreset::Neon;
+            if (preset != _transferPreset) {
+                ApplyTransferPreset(preset);
+            }
+        }
     }
 
     void App::UpdateTransferFunctionTexture() {
         VCX::Engine::Texture2D<VCX::Engine::Formats::RGBA8> lut(kTransferLutSize, 1);
+        std::vector<glm::vec4> samples(kTransferLutSize);
+        std::size_t leadingClear = 0;  // texels of zero alpha at the low end
+        std::size_t trailingClear = 0; // and at the high end
         for (std::size_t i = 0; i < kTransferLutSize; ++i) {
             float sample = static_cast<float>(i) / static_cast<float>(kTransferLutSize - 1);
-            lut.At(i, 0) = EvaluateTransferFunction(sample);
-        }
+            auto const value = EvaluateTransferFunction(sample);
+            lut.At(i, 0) = value;
+            samples[i] = value;
+            bool const clear = VCX::Engine::Formats::R8::Encode(value.a) == 0;
+            trailingClear = clear ? trailingClear + 1 : 0;
+            leadingClear += clear && leadingClear == i ? 1 : 0;
+        }
+        // A density reads only zero-alpha texels through the linear filter within half a texel of the clear runs.
+        // Below half a texel it reads just the first texel, which the raymarcher composites in closed form.
+        float const texel = 1.f / static_cast<float>(kTransferLutSize);
+        _lutEmptyRange = glm::vec2(
+            std::max((static_cast<float>(leadingClear) - 0.5f) * texel - kBrickDensityMargin, kBlankDensityTexels * texel),
+            (static_cast<float>(kTransferLutSize - trailingClear) + 0.5f) * texel + kBrickDensityMargin);
         _transferLutTexture.UpdateSampler({
             VCX::Engine::GL::WrapMode::Clamp,
             VCX::Engine::GL::WrapMode::Clamp,
@@ -1659,6 +1845,174 @@ namespace VCX::Apps::SphereAudioVisualizer {
         });
         _transferLutTexture.Update(lut);
         _transferDirty = false;
+        if (_renderSettings.Preintegrated) {
+            RequestPreintegratedTable(std::move(samples));
+        } else {
+            _preintegratedReady = false; // stale from here on; rebuilt when the option comes back
+        }
+    }
+
+    void App::RequestPreintegratedTable(std::vector<glm::vec4> samples) {
+        // Emplace would join a running build, so edits made meanwhile wait for it; only the latest is kept.
+        if (_preintegrationRunning) {
+            _preintegrationSamples = std::move(samples);
+            _preintegrationQueued = true;
+            return;
+        }
+        _preintegrationRunning = true;
+        _preintegrationJob.Emplace([samples = std::move(samples)]() {
+            return BuildPreintegratedTable(samples);
+        });
+    }
+
+    void App::PollPreintegratedTable() {
+        if (!_preintegrationRunning || !_preintegrationJob.IsCompleted()) return;
+        _preintegrationRunning = false;
+        _preintegratedLutTexture.UpdateSampler({
+            VCX::Engine::GL::WrapMode::Clamp,
+            VCX::Engine::GL::WrapMode::Clamp,
+            VCX::Engine::GL::WrapMode::Clamp,
+            VCX::Engine::GL::FilterMode::Linear,
+            VCX::Engine::GL::FilterMode::Linear,
+        });
+        _preintegratedLutTexture.Update(_preintegrationJob.Value());
+        _preintegratedReady = true;
+        if (_preintegrationQueued) {
+            _preintegrationQueued = false;
+            RequestPreintegratedTable(std::move(_preintegrationSamples));
+        }
+    }
+
+    void App::UpdateOnsets(float deltaTime) {
+        float const decay = std::exp(-std::max(deltaTime, 0.f) / kOnsetPulseDecay);
+        for (auto & pulse : _onsetPulse) {
+            pulse *= decay;
+        }
+
+        auto const sampleRate = _audio.GetSampleRate();
+        std::uint64_t const written = _audio.GetWrittenSamples();
+        if (!_analysisSettings.OnsetEnabled || sampleRate == 0) {
+            _onsetCursor = written;
+            _bassOnsetPending = false;
+            return;
+        }
+
+        std::uint64_t const frameSize = OnsetDetector::kFrameSize;
+        std::uint64_t const hopSize = OnsetDetector::kHopSize;
+        // The ring restarts from zero on every load; start over whenever the clock runs backwards.
+        bool const clockRewound = _onsetCursor > frameSize && written + hopSize < _onsetCursor;
+        if (_onsetCursor == 0 || clockRewound || _onsetDetector.GetSampleRate() != sampleRate) {
+            _onsetDetector.Reset(sampleRate);
+            _tempoTracker.Reset(static_cast<float>(sampleRate) / static_cast<float>(hopSize));
+            _onsetCursor = 0;
+        }
+        _onsetDetector.SetSettings({
+            .Sensitivity = _analysisSettings.OnsetSensitivity,
+            .MinInterval = _analysisSettings.OnsetMinInterval,
+        });
+        auto tempoSettings = _tempoTracker.GetSettings();
+        tempoSettings.PriorBpm = std::clamp(_analysisSettings.TempoPriorBpm, tempoSettings.MinBpm, tempoSettings.MaxBpm);
+        _tempoTracker.SetSettings(tempoSettings);
+
+        if (_featureTimelineActive) {
+            // Onsets and envelope were precomputed per hop; replay the frames played since the last update.
+            auto const & timeline = _audio.GetFeatureTimeline();
+            auto const frame = static_cast<std::int64_t>(_featureFrame);
+            if (frame < _featureOnsetFrame || frame - _featureOnsetFrame > static_cast<std::int64_t>(kMaxOnsetHopsPerFrame)) {
+                _featureOnsetFrame = frame - 1;
+            }
+            for (auto f = _featureOnsetFrame + 1; f <= frame; ++f) {
+                std::uint8_t const flags = timeline.GetOnsetFlags(static_cast<std::size_t>(f));
+                float const onsetWeight = (flags & 1u) ? 1.f : (flags != 0 ? 0.5f : 0.f);
+                _tempoTracker.ProcessHop(timeline.GetOnsetEnvelope(static_cast<std::size_t>(f)), onsetWeight);
+                for (std::size_t g = 0; g < OnsetDetector::kNumGroups; ++g) {
+                    if (flags & (1u << g)) {
+                        _onsetPulse[g] = std::max(_onsetPulse[g], 0.5f);
+                        ++_onsetCounter;
+                    }
+                }
+                if (flags & 1u) {
+                    _bassOnsetPending = true;
+                }
+            }
+            _featureOnsetFrame = frame;
+            _onsetCursor = std::max(written, frameSize);
+            return;
+        }
+        _featureOnsetFrame = -1;
+
+        _onsetCursor = std::max(_onsetCursor, frameSize);
+        if (written >= _onsetCursor + kMaxOnsetHopsPerFrame * hopSize) {
+            _onsetCursor = written - (kMaxOnsetHopsPerFrame - 1) * hopSize;
+        }
+
+        _onsetFrame.resize(OnsetDetector::kFrameSize);
+        _onsetEvents.clear();
+        while (_onsetCursor <= written) {
+            if (_audio.CopyWindowAt(_onsetFrame.data(), _onsetFrame.size(), _onsetCursor)) {
+                std::size_t const first = _onsetEvents.size();
+                _onsetDetector.ProcessFrame(_onsetFrame.data(), _onsetCursor, _onsetEvents);
+                // Kick onsets carry the beat; onsets from the other groups only nudge the clock.
+                float onsetWeight = 0.f;
+                for (std::size_t i = first; i < _onsetEvents.size(); ++i) {
+                    float const groupWeight = _onsetEvents[i].Band == OnsetDetector::Group::Low ? 1.f : 0.5f;
+                    onsetWeight = std::max(onsetWeight, groupWeight * std::min(_onsetEvents[i].Strength * 0.5f, 1.f));
+                }
+                _tempoTracker.ProcessHop(_onsetDetector.GetEnvelope(), onsetWeight);
+            }
+            _onsetCursor += hopSize;
+        }
+
+        for (auto const & onset : _onsetEvents) {
+            auto const group = static_cast<std::size_t>(onset.Band);
+            _onsetPulse[group] = std::max(_onsetPulse[group], std::min(onset.Strength / 4.f, 1.f));
+            if (onset.Band == OnsetDetector::Group::Low) {
+                _bassOnsetPending = true;
+            }
+        }
+        _onsetCounter += _onsetEvents.size();
+    }
+
+    void App::UpdateAnalysisTap() {
+        auto const sampleRate = _audio.GetSampleRate();
+        std::uint64_t const written = _audio.GetWrittenSamples();
+        bool const wasSliding = _slidingDftActive;
+        _slidingDftActive = !_featureTimelineActive && sampleRate != 0
+            && SlidingDftSpectrum::IsSelected(_analysisSettings, CurrentFps(), sampleRate, wasSliding);
+        if (sampleRate == 0) {
+            _tapCursor = written;
+            return;
+        }
+
+        if (_loudnessMeter.GetSampleRate() != sampleRate) {
+            _loudnessMeter.Reset(sampleRate);
+        }
+        if (_slidingDftActive) {
+            _slidingDft.Configure(_analysisSettings, sampleRate);
+            if (!wasSliding) {
+                _slidingDft.Reset();
+            }
+        }
+        // The ring restarts from zero on every load.
+        if (written < _tapCursor) {
+            _slidingDft.Reset();
+            _loudnessMeter.Reset(sampleRate);
+            _tapCursor = written;
+        }
+        if (written - _tapCursor > kMaxTapBacklog) {
+            _slidingDft.Reset();
+            _tapCursor = written - kMaxTapBacklog;
+        }
+        // Feed every sample written since the last frame, so the results include the newest one.
+        std::size_t const count = static_cast<std::size_t>(written - _tapCursor);
+        _tapBlock.resize(count);
+        if (count > 0 && _audio.CopyWindowAt(_tapBlock.data(), count, written)) {
+            if (_slidingDftActive) {
+                _slidingDft.ProcessBlock(_tapBlock.data(), count);
+            }
+            _loudnessMeter.Process(_tapBlock.data(), count);
+        }
+        _tapCursor = written;
     }
 
     void App::UpdateAudioAnalysis(float deltaTime) {
@@ -1675,6 +2029,30 @@ namespace VCX::Apps::SphereAudioVisualizer {
             sLoggedInit = true;
         }
 
+        _audio.SetFeatureSettings(settings);
+        _audio.PollFeatureTimeline();
+        auto const & timeline = _audio.GetFeatureTimeline();
+        std::uint64_t const featureHash = FeatureTimeline::HashSettings(settings);
+        bool const timelineMatches = timeline.IsOpen() && timeline.GetSettingsHash() == featureHash;
+        // Rebuild the timeline once the feature settings have been left alone for a moment.
+        if (settings.UseFeatureTimeline && _audio.IsLoaded() && !timelineMatches && !_audio.IsFeatureJobRunning() && featureHash != _featureRequestedHash) {
+            _featureRequestTimer += deltaTime;
+            if (_featureRequestTimer >= 1.f) {
+                _featureRequestTimer = 0.f;
+                _featureRequestedHash = featureHash;
+                _audio.RequestFeatureTimeline();
+            }
+        } else {
+            _featureRequestTimer = 0.f;
+        }
+        _featureTimelineActive = settings.UseFeatureTimeline && timelineMatches && _audio.IsLoaded() && !_audio.UsingSineFallback()
+            && timeline.GetNumBands() == static_cast<std::size_t>(settings.NumBands);
+
+        auto const slidingStart = std::chrono::high_resolution_clock::now();
+        UpdateAnalysisTap();
+        auto const slidingEnd = std::chrono::high_resolution_clock::now();
+        float const slidingMs = std::chrono::duration<float, std::milli>(slidingEnd - slidingStart).count();
+
         if (_fftCfg == nullptr || state.CachedWindowSize != _fftSize) {
             if (_fftCfg) {
                 kiss_fft_free(_fftCfg);
@@ -1684,11 +2062,16 @@ namespace VCX::Apps::SphereAudioVisualizer {
             spdlog::info("Rebuild FFT cfg size {} (cfg null? {})", _fftSize, _fftCfg == nullptr);
         }
 
-        if (state.Window.size() != fftSize) {
-            state.Window.assign(fftSize, 0.f);
+        // The multi-resolution levels all read the tail of one window as long as their largest transform.
+        std::size_t const windowSize = settings.MultiResolution ? MultiResolutionSpectrum::kMaxSize : fftSize;
+        if (settings.MultiResolution) {
+            _multiResSpectrum.Configure(settings, _audio.GetSampleRate());
+        }
+        if (state.Window.size() != windowSize) {
+            state.Window.assign(windowSize, 0.f);
         }
-        if (state.Spectrum.size() != fftSize / 2) {
-            state.Spectrum.assign(fftSize / 2, 0.f);
+        if (state.Spectrum.size() != windowSize / 2) {
+            state.Spectrum.assign(windowSize / 2, 0.f);
         }
         if (state.BandEnergies.size() != static_cast<std::size_t>(settings.NumBands)) {
             state.BandEnergies.assign(static_cast<std::size_t>(settings.NumBands), 0.f);
@@ -1699,62 +2082,117 @@ namespace VCX::Apps::SphereAudioVisualizer {
         if (state.FftOut.size() != fftSize) {
             state.FftOut.resize(fftSize);
         }
-        if (state.WindowCoeffs.size() != fftSize || state.CachedWindow != settings.Window) {
-            BuildWindowCoeffs(state.WindowCoeffs, _fftSize, settings.Window);
-            state.CachedWindow = settings.Window;
-            spdlog::debug("Window coeffs built size {} type {}", _fftSize, static_cast<int>(settings.Window));
-        }
+        state.WindowCoeffs = &GetWindowCoeffs(_fftSize, settings.Window, settings.KaiserBeta);
 
         int headroom = std::clamp(_audioHeadroom, 0, _fftSize * 2);
         _audioHeadroom = headroom;
         auto readable = _audio.GetAvailableSamples();
         _audioReadable = readable;
 
-        std::size_t read = _audio.GetLatestWindow(state.Window.data(), fftSize, static_cast<std::size_t>(headroom));
-        if (read < fftSize) {
+        std::size_t read = _audio.GetLatestWindow(state.Window.data(), windowSize, static_cast<std::size_t>(headroom));
+        if (read < windowSize) {
             ++state.Underruns;
         } else {
             ++_fftUpdateCounter;
         }
 
-        _energiesUpdatedThisFrame = (read >= fftSize);
-
-        float mean = 0.f;
-        if (!state.Window.empty()) {
-            mean = std::accumulate(state.Window.begin(), state.Window.end(), 0.f) / static_cast<float>(state.Window.size());
-        }
-        float sumSquares = 0.f;
-        for (auto & sample : state.Window) {
-            sample -= mean;
-            sumSquares += sample * sample;
-        }
-        _audioWindowRms = state.Window.empty() ? 0.f : std::sqrt(sumSquares / static_cast<float>(state.Window.size()));
-
-        ApplyWindow(state.WindowCoeffs, state.Window, _fftSize);
-
-        auto const fftStart = std::chrono::high_resolution_clock::now();
-        if (_fftCfg) {
-            for (std::size_t i = 0; i < fftSize; ++i) {
-                state.FftIn[i].r = state.Window[i];
-                state.FftIn[i].i = 0.f;
+        _energiesUpdatedThisFrame = (read >= windowSize);
+        if (_slidingDftActive) {
+            _energiesUpdatedThisFrame = true;
+        }
+        if (_featureTimelineActive) {
+            std::size_t const frame = timeline.FrameAt(_audio.GetTimeSeconds());
+            _energiesUpdatedThisFrame = frame != _featureFrame;
+            _featureFrame = frame;
+        }
+
+        // One pass for mean and RMS. The FFT path removes the mean while windowing into its input below;
+        // the other paths read the centred window directly.
+        WindowStats const windowStats = MeasureWindow(state.Window.data(), state.Window.size());
+        _audioWindowRms = windowStats.Rms;
+        bool const directFft = !_featureTimelineActive && !_slidingDftActive && !settings.MultiResolution;
+        if (!directFft) {
+            RemoveMean(state.Window.data(), state.Window.size(), windowStats.Mean);
+        }
+        // The same window span from the left/right ring, for the packed stereo transform.
+        _audio.SetStereoCapture(settings.StereoEnabled);
+        _stereoActive = false;
+        if (directFft && settings.StereoEnabled && _audio.GetChannels() >= 2 && read >= windowSize) {
+            _stereoLeft.resize(windowSize);
+            _stereoRight.resize(windowSize);
+            _stereoActive = _audio.CopyStereoWindowAt(_stereoLeft.data(), _stereoRight.data(), windowSize, _audio.GetWrittenSamples());
+        }
+
+        if (_featureTimelineActive) {
+            timeline.GetBandEnergies(_featureFrame, state.BandEnergies);
+            timeline.GetSpectrum(_featureFrame, state.SpectrumDownsample);
+            state.LastFftMs = 0.f;
+
+            float const frameRate = timeline.GetFrameRate();
+            float const lookahead = std::max(settings.LookaheadSeconds, 0.1f);
+            auto const aheadFrames = static_cast<std::size_t>(lookahead * frameRate);
+            auto const recentFrames = static_cast<std::size_t>(0.5f * frameRate);
+            auto const recent = timeline.FindPeakRms(_featureFrame - std::min(_featureFrame, recentFrames), _featureFrame);
+            auto const upcoming = timeline.FindPeakRms(_featureFrame + 1, _featureFrame + aheadFrames);
+            float const rise = std::clamp((upcoming.RmsDb - recent.RmsDb) / 18.f, 0.f, 1.f);
+            float const eta = static_cast<float>(upcoming.Frame - std::min(upcoming.Frame, _featureFrame)) / (frameRate * lookahead);
+            _anticipation = rise * std::clamp(1.f - eta, 0.f, 1.f);
+        } else if (_slidingDftActive) {
+            _anticipation = 0.f;
+            _slidingDft.GetBandEnergies(state.BandEnergies);
+            state.LastFftMs = slidingMs;
+        } else if (settings.MultiResolution) {
+            _anticipation = 0.f;
+            auto const fftStart = std::chrono::high_resolution_clock::now();
+            // Each level only runs once its own hop of new audio has arrived, so the 4096-point
+            // transform is skipped on most frames while the short one follows every frame.
+            unsigned const due = _multiResSpectrum.DueLevels(_audio.GetWrittenSamples());
+            _multiResSpectrum.Process(state.Window.data(), due);
+            _multiResSpectrum.GetBandEnergies(state.BandEnergies);
+            state.Spectrum = _multiResSpectrum.GetSpectrum(0);
+            auto const fftEnd = std::chrono::high_resolution_clock::now();
+            state.LastFftMs = std::chrono::duration<float, std::milli>(fftEnd - fftStart).count();
+        } else {
+            _anticipation = 0.f;
+            auto const fftStart = std::chrono::high_resolution_clock::now();
+            if (_stereoActive) {
+                // Both channels from one complex transform; its mid spectrum stands in for the mono one.
+                RemoveMean(state.Window.data(), fftSize, windowStats.Mean);
+                _stereo.Configure(settings, _fftSize, _audio.GetSampleRate());
+                _stereo.Process(_stereoLeft.data(), _stereoRight.data(), *state.WindowCoeffs, !_audio.GetMonoMixMode(), deltaTime);
+                auto const & mid = _stereo.GetMidSpectrum();
+                std::copy_n(mid.begin(), std::min(mid.size(), state.Spectrum.size()), state.Spectrum.begin());
+            } else if (_fftCfg) {
+                WindowIntoFft(state.Window.data(), windowStats.Mean, *state.WindowCoeffs, state.FftIn.data(), fftSize);
+                kiss_fft(_fftCfg, state.FftIn.data(), state.FftOut.data());
+                for (std::size_t i = 0; i < state.Spectrum.size(); ++i) {
+                    float re = state.FftOut[i].r;
+                    float im = state.FftOut[i].i;
+                    state.Spectrum[i] = std::sqrt(re * re + im * im) / static_cast<float>(_fftSize);
+                }
+            } else {
+                RemoveMean(state.Window.data(), fftSize, windowStats.Mean);
+                std::fill(state.Spectrum.begin(), state.Spectrum.end(), 0.f);
             }
-            kiss_fft(_fftCfg, state.FftIn.data(), state.FftOut.data());
-            for (std::size_t i = 0; i < state.Spectrum.size(); ++i) {
-                float re = state.FftOut[i].r;
-                float im = state.FftOut[i].i;
-                state.Spectrum[i] = std::sqrt(re * re + im * im) / static_cast<float>(_fftSize);
+            auto const fftEnd = std::chrono::high_resolution_clock::now();
+            state.LastFftMs = std::chrono::duration<float, std::milli>(fftEnd - fftStart).count();
+
+            for (int b = 0; b < settings.NumBands; ++b) {
+                BandRange range = ComputeBandRange(settings, b, settings.NumBands, _fftSize, static_cast<int>(_audio.GetSampleRate()));
+                float energy = AggregateBand(state.Spectrum, range, settings.Aggregate);
+                energy = ApplyCompression(energy, settings.CompressK);
+                state.BandEnergies[static_cast<std::size_t>(b)] = energy;
             }
-        } else {
-            std::fill(state.Spectrum.begin(), state.Spectrum.end(), 0.f);
         }
-        auto const fftEnd = std::chrono::high_resolution_clock::now();
-        state.LastFftMs = std::chrono::duration<float, std::milli>(fftEnd - fftStart).count();
 
-        for (int b = 0; b < settings.NumBands; ++b) {
-            BandRange range = ComputeBandRange(settings, b, settings.NumBands, _fftSize, static_cast<int>(_audio.GetSampleRate()));
-            float energy = AggregateBand(state.Spectrum, range, settings.Aggregate);
-            energy = ApplyCompression(energy, settings.CompressK);
-            state.BandEnergies[static_cast<std::size_t>(b)] = energy;
+        if (_stereoActive) {
+            state.BandPan = _stereo.GetBandPan();
+            state.BandWidth = _stereo.GetBandWidth();
+            state.StereoBalance = _stereo.GetBalance();
+        } else {
+            state.BandPan.clear();
+            state.BandWidth.clear();
+            state.StereoBalance = 0.f;
         }
 
         float maxEnergy = 0.f;
@@ -1773,8 +2211,18 @@ namespace VCX::Apps::SphereAudioVisualizer {
         state.EnergyAvg = state.BandEnergies.empty() ? 0.f : sumEnergy / static_cast<float>(state.BandEnergies.size());
 
         float gain = 1.f;
-        if (settings.AgcEnabled) {
-            gain = UpdateAgcGain(state.AgcGain, state.EnergyMax, settings, deltaTime);
+        if (settings.Normalization == BandNormalization::Quantile) {
+            // Each band against its own recent range; Process also clamps to [0, 1].
+            state.AgcGain = 1.f;
+            _quantileNormalizer.Configure(settings, state.BandEnergies.size());
+            _quantileNormalizer.Process(state.BandEnergies, deltaTime);
+        } else if (settings.AgcEnabled) {
+            float agcLevel = state.EnergyMax;
+            if (settings.AgcLevelSource == AgcSource::Loudness) {
+                // Follow perceived loudness rather than the loudest band, expressed on the band energy scale.
+                agcLevel = ApplyCompression(_loudnessMeter.GetShortTermRms() * kLoudnessToBandMagnitude, settings.CompressK);
+            }
+            gain = UpdateAgcGain(state.AgcGain, agcLevel, settings, deltaTime);
             state.AgcGain = gain;
         } else {
             state.AgcGain = 1.f;
@@ -1799,29 +2247,87 @@ namespace VCX::Apps::SphereAudioVisualizer {
         state.EnergyMax = normMax;
         state.EnergyAvg = state.BandEnergies.empty() ? 0.f : normSum / static_cast<float>(state.BandEnergies.size());
 
-        int bassBands = std::min<int>(static_cast<int>(state.BandEnergies.size()), 3);
-        float bassSum = 0.f;
-        for (int i = 0; i < bassBands; ++i) {
-            bassSum += state.BandEnergies[static_cast<std::size_t>(i)];
+        std::size_t const bandCount = state.BandEnergies.size();
+        _audioBass = AverageRange(state.BandEnergies, 0, std::min<std::size_t>(bandCount, 3));
+        _audioTreble = AverageRange(state.BandEnergies, bandCount - std::min<std::size_t>(bandCount, 3), bandCount);
+
+        // Shells follow the harmonic part and sparks the percussive part when the split is on.
+        _hpssActive = settings.HpssEnabled && !_featureTimelineActive && !_slidingDftActive && !state.Spectrum.empty();
+        std::vector<float> const * shellBands = &state.BandEnergies;
+        _sparkBass = _audioBass;
+        _sparkTreble = _audioTreble;
+        if (_hpssActive) {
+            if (_energiesUpdatedThisFrame) {
+                auto const hpssStart = std::chrono::high_resolution_clock::now();
+                _hpss.Configure(settings, state.Spectrum.size());
+                _hpss.Process(state.Spectrum);
+                auto const hpssEnd = std::chrono::high_resolution_clock::now();
+                _hpssMs = std::chrono::duration<float, std::milli>(hpssEnd - hpssStart).count();
+            }
+            // The spectrum covers DC to Nyquist, so its transform size is twice its length, whichever path filled it.
+            _hpss.SplitBands(settings, static_cast<int>(state.Spectrum.size() * 2), static_cast<int>(_audio.GetSampleRate()),
+                state.BandEnergies, state.HarmonicBands, state.PercussiveBands);
+            shellBands = &state.HarmonicBands;
+            _sparkBass = AverageRange(state.PercussiveBands, 0, std::min<std::size_t>(bandCount, 3));
+            _sparkTreble = AverageRange(state.PercussiveBands, bandCount - std::min<std::size_t>(bandCount, 3), bandCount);
+        } else {
+            state.HarmonicBands.clear();
+            state.PercussiveBands.clear();
         }
-        _audioBass = bassBands > 0 ? bassSum / static_cast<float>(bassBands) : 0.f;
 
-        int const bandCount = static_cast<int>(state.BandEnergies.size());
-        int trebleStart = std::max(0, bandCount - 3);
-        float trebleSum = 0.f;
-        int trebleCount = 0;
-        for (int i = trebleStart; i < bandCount; ++i) {
-            trebleSum += state.BandEnergies[static_cast<std::size_t>(i)];
-            ++trebleCount;
-        }
-        _audioTreble = trebleCount > 0 ? trebleSum / static_cast<float>(trebleCount) : 0.f;
+        // Smoothed once here, every frame, for whichever volume builder runs below.
+        _envelope.Configure(settings, shellBands->size());
+        _envelope.Process(*shellBands, deltaTime);
 
-        if (!state.Spectrum.empty()) {
-            DownsampleSpectrum(state.Spectrum, state.SpectrumDownsample, 128);
+        UpdateOnsets(deltaTime);
+
+        if (_featureTimelineActive) {
+            // Already filled from the timeline.
+        } else if (_slidingDftActive) {
+            state.SpectrumDownsample.clear(); // no full spectrum on the sliding path
+        } else if (!state.Spectrum.empty()) {
+            DownsampleSpectrum(state.Spectrum, state.SpectrumDownsample, FeatureTimeline::kSpectrumBins);
         } else {
             state.SpectrumDownsample.clear();
         }
 
+        // All descriptors in one pass, from whichever spectrum this path produced.
+        if (_energiesUpdatedThisFrame) {
+            auto const descriptorStart = std::chrono::high_resolution_clock::now();
+            if (_featureTimelineActive) {
+                _descriptorKernel.Process(state.SpectrumDownsample, state.Window);
+            } else if (_slidingDftActive) {
+                _descriptorKernel.ProcessWindow(state.Window);
+            } else {
+                _descriptorKernel.Process(state.Spectrum, state.Window);
+            }
+            state.Descriptors = _descriptorKernel.GetDescriptors();
+            auto const descriptorEnd = std::chrono::high_resolution_clock::now();
+            _descriptorMs = std::chrono::duration<float, std::milli>(descriptorEnd - descriptorStart).count();
+        }
+
+        // Chroma from the same spectrum; a new key estimate may move the transfer-function palette.
+        if (_energiesUpdatedThisFrame && settings.ChromaEnabled && !_featureTimelineActive && !_slidingDftActive && !state.Spectrum.empty()) {
+            _chroma.Configure(static_cast<int>(state.Spectrum.size() * 2), static_cast<int>(_audio.GetSampleRate()));
+            bool const keyUpdated = _chroma.Process(settings, state.Spectrum, deltaTime);
+            state.Chroma = _chroma.GetChroma();
+            state.Key = _chroma.GetKey();
+            if (keyUpdated) {
+                ApplyKeyToTransfer(state.Key);
+            }
+        }
+
+        // One spectrogram row per analysis frame, on the normalised band energy scale.
+        if (_energiesUpdatedThisFrame && !state.SpectrumDownsample.empty()) {
+            _spectrogram.Resize(FeatureTimeline::kSpectrumBins, kSpectrogramRows);
+            _spectrogramRow.resize(state.SpectrumDownsample.size());
+            for (std::size_t i = 0; i < _spectrogramRow.size(); ++i) {
+                _spectrogramRow[i] = std::clamp(ApplyCompression(state.SpectrumDownsample[i], settings.CompressK) * gain, 0.f, 1.f);
+            }
+            _spectrogram.Push(_spectrogramRow);
+            _spectrogramTexture.Sync(_spectrogram);
+        }
+
         auto const volumeSettings = _volumeData.GetSettings();
         bool const useGpuBuilder = _useGpuBuild && _computeSupported;
         bool sizeChanged = false;
@@ -1840,17 +2346,28 @@ namespace VCX::Apps::SphereAudioVisualizer {
 
         bool const shouldBuildVolume = !_buildOnEnergyUpdate || _energiesUpdatedThisFrame || sizeChanged;
         if (shouldBuildVolume) {
+            ComposeAngularCoefficients(
+                AngularSources {
+                    .Pan = &state.BandPan,
+                    .Width = &state.BandWidth,
+                    .OnsetPulse = _onsetPulse,
+                    .PanGain = volumeSettings.StereoPan,
+                    .WidthGain = volumeSettings.StereoWidth,
+                    .OnsetGain = volumeSettings.OnsetKick,
+                },
+                _envelope.GetOutput().size(),
+                _angularCoeffs);
             if (sizeChanged) {
                 spdlog::info("Volume size changed to {}, forcing rebuild.", volumeSettings.VolumeSize);
             }
             if (useGpuBuilder) {
                 _gpuVolumeBuilder.EnsureResources(volumeSettings.VolumeSize);
-                auto const buildStats = _gpuVolumeBuilder.DispatchBuild(state.BandEnergies, volumeSettings);
+                auto const buildStats = _gpuVolumeBuilder.DispatchBuild(_envelope.GetOutput(), _angularCoeffs, volumeSettings);
                 _volumeBuildMs = buildStats.BuildMs;
                 _volumeUploadMs = buildStats.UploadMs;
                 _gpuBuildMs = buildStats.BuildMs;
             } else {
-                auto const volumeStats = _volumeData.UpdateVolume(state.BandEnergies);
+                auto const volumeStats = _volumeData.UpdateVolume(_envelope.GetOutput(), _angularCoeffs);
                 _volumeBuildMs = volumeStats.BuildMs;
                 _volumeUploadMs = volumeStats.UploadMs;
                 _gpuBuildMs = 0.f;
@@ -1887,6 +2404,8 @@ namespace VCX::Apps::SphereAudioVisualizer {
             _audioLogTimer -= 1.f;
             _fftUpdatesPerSecond = _fftUpdateCounter;
             _fftUpdateCounter = 0;
+            _onsetsPerSecond = _onsetCounter;
+            _onsetCounter = 0;
             float fill = _audio.GetRingFillRatio();
             spdlog::info("Audio stats fill {:.3f}, readable {}, fftUpdates {}, windowRMS {:.5f}, overrun {}, dropped {}, underrun {}, headroom {}",
                 fill,
@@ -1911,14 +2430,19 @@ namespace VCX::Apps::SphereAudioVisualizer {
         auto const volumeSize = _volumeData.GetVolumeSize();
         bool const useGpuTexture = !_forceCpuBuild && _useGpuBuild && _computeSupported;
         auto const volumeTex = useGpuTexture ? _gpuVolumeBuilder.GetVolumeTexture() : _volumeData.GetVolumeTextureId();
+        auto const brickTex = useGpuTexture ? _gpuVolumeBuilder.GetBrickTexture() : _volumeData.GetBrickTextureId();
         auto const renderStart = std::chrono::high_resolution_clock::now();
         auto const windowSize = VCX::Engine::GetCurrentWindowSize();
         if (volumeSize == 0 || volumeTex == 0 || windowSize.first == 0 || windowSize.second == 0) {
             _renderMs = 0.f;
+            _historyValid = false;
             return;
         }
 
-        ResetStatsBuffer();
+        bool const stats = _raymarchStatsVisible && _statsBuffer;
+        if (stats) {
+            ResetStatsBuffer();
+        }
 
         GLboolean depthBefore = glIsEnabled(GL_DEPTH_TEST);
         GLint depthMaskBefore = 0;
@@ -1941,47 +2465,182 @@ namespace VCX::Apps::SphereAudioVisualizer {
         auto const aspect = float(windowSize.first) / float(windowSize.second);
         auto const view = _camera.GetViewMatrix();
         auto const proj = _camera.GetProjectionMatrix(aspect);
-        auto const invViewProj = glm::inverse(proj * view);
+        auto const viewProj = proj * view;
+        auto const invViewProj = glm::inverse(viewProj);
         auto const screenSize = glm::vec2(float(windowSize.first), float(windowSize.second));
-
-        auto & uniforms = _volumeProgram.GetUniforms();
+        int const divisor = ClampResolutionDivisor(_renderSettings.ResolutionDivisor);
+        glm::ivec2 const lowSize {
+            (static_cast<int>(windowSize.first) + divisor - 1) / divisor,
+            (static_cast<int>(windowSize.second) + divisor - 1) / divisor,
+        };
+        bool const offscreen = (divisor > 1 || _renderSettings.TemporalAccumulation) && EnsureVolumeTargets(lowSize);
+        bool const temporal = offscreen && _renderSettings.TemporalAccumulation;
+
+        auto & volumeProgram = _volumePrograms.Get({
+            "SHELL_MODE " + std::to_string(static_cast<int>(_dynamicSettings.Mode)),
+            "COLOR_MODE " + std::to_string(static_cast<int>(_renderSettings.Mode)),
+            "ENABLE_JITTER " + std::to_string(_renderSettings.EnableJitter ? 1 : 0),
+            "ENABLE_STATS " + std::to_string(stats ? 1 : 0),
+        });
+        auto & uniforms = volumeProgram.GetUniforms();
         uniforms.SetByName("uInvViewProj", invViewProj);
         uniforms.SetByName("uCameraPos", _camera.Eye);
-        uniforms.SetByName("uScreenSize", screenSize);
+        uniforms.SetByName("uScreenSize", offscreen ? glm::vec2(lowSize) : screenSize);
         uniforms.SetByName("uTime", _time);
-        uniforms.SetByName("uStepSize", _renderSettings.StepSize);
-        uniforms.SetByName("uMaxSteps", _renderSettings.MaxSteps);
+        uniforms.SetByName("uTolerance", _renderSettings.ErrorTolerance);
         uniforms.SetByName("uAlphaScale", _renderSettings.AlphaScale);
-        uniforms.SetByName("uColorMode", static_cast<int>(_renderSettings.Mode));
-        uniforms.SetByName("uEnableJitter", _renderSettings.EnableJitter ? 1 : 0);
         uniforms.SetByName("uJitterSeed", static_cast<float>(_frameIndex));
+        uniforms.SetByName("uBlueNoise", _blueNoiseLoaded ? 1 : 0);
+        uniforms.SetByName("uJitterRotation", static_cast<float>(std::fmod(static_cast<double>(_frameIndex) * kGoldenRatioConjugate, 1.0)));
         uniforms.SetByName("uVolumeMin", kVolumeMin);
         uniforms.SetByName("uVolumeMax", kVolumeMax);
-        uniforms.SetByName("uNoiseStrength", _dynamicSettings.NoiseStrength);
-        uniforms.SetByName("uNoiseFreq", _dynamicSettings.NoiseFreq);
-        uniforms.SetByName("uNoiseSpeed", _dynamicSettings.NoiseSpeed);
-        uniforms.SetByName("uRippleAmp", _dynamicSettings.RippleAmp);
-        uniforms.SetByName("uRippleFreq", _dynamicSettings.RippleFreq);
-        uniforms.SetByName("uRippleSpeed", _dynamicSettings.RippleSpeed);
+        uniforms.SetByName("uNoiseStrength", ModulatedDynamic(ModulationTarget::NoiseStrength, _dynamicSettings.NoiseStrength));
+        uniforms.SetByName("uNoiseFreq", ModulatedDynamic(ModulationTarget::NoiseFreq, _dynamicSettings.NoiseFreq));
+        uniforms.SetByName("uNoiseSpeed", ModulatedDynamic(ModulationTarget::NoiseSpeed, _dynamicSettings.NoiseSpeed));
+        uniforms.SetByName("uRippleAmp", ModulatedDynamic(ModulationTarget::RippleAmp, _dynamicSettings.RippleAmp));
+        uniforms.SetByName("uRippleFreq", ModulatedDynamic(ModulationTarget::RippleFreq, _dynamicSettings.RippleFreq));
+        uniforms.SetByName("uRippleSpeed", ModulatedDynamic(ModulationTarget::RippleSpeed, _dynamicSettings.RippleSpeed));
         uniforms.SetByName("uBass", _audioBass);
-        uniforms.SetByName("uShellMode", static_cast<int>(_dynamicSettings.Mode));
+        auto const & descriptors = _analysisState.Descriptors;
+        uniforms.SetByName("uSpectralShape", glm::vec3(descriptors.Centroid, descriptors.Rolloff, descriptors.Flatness));
+        uniforms.SetByName("uSpectralMotion", glm::vec3(descriptors.Flux, descriptors.Crest, descriptors.ZeroCrossing));
+        uniforms.SetByName("uOnsetPulse", glm::vec3(_onsetPulse[0], _onsetPulse[1], _onsetPulse[2]));
+        uniforms.SetByName("uBpm", _tempoTracker.GetBpm());
+        uniforms.SetByName("uBeatPhase", _tempoTracker.GetBeatPhase());
+        float const beatConfidence = _analysisSettings.OnsetEnabled ? _tempoTracker.GetConfidence() : 0.f;
+        uniforms.SetByName("uBeatConfidence", beatConfidence);
+
+        // Bricks are widened by one brick, so skipping stays exact while the shell warp moves samples less than that.
+        float const beatSeconds = _tempoTracker.GetBpm() > 0.f ? 60.f / _tempoTracker.GetBpm() : 0.5f;
+        float const beatPulse = beatConfidence * std::exp(-_tempoTracker.GetBeatPhase() * beatSeconds / kBeatPulseSeconds);
+        float const warpBound = _dynamicSettings.Mode == PerturbMode::Ripple
+            ? std::abs(ModulatedDynamic(ModulationTarget::RippleAmp, _dynamicSettings.RippleAmp)) * (std::abs(_audioBass) + 0.5f * _onsetPulse[0] + 0.5f * beatPulse + 0.5f * descriptors.Flux)
+            : std::abs(ModulatedDynamic(ModulationTarget::NoiseStrength, _dynamicSettings.NoiseStrength)) * std::abs(_audioBass);
+        auto const brickGrid = SphereVolumeData::BrickGridSize(volumeSize);
+        float const voxelExtent = (kVolumeMax.x - kVolumeMin.x) / static_cast<float>(volumeSize);
+        bool const skipEmpty = _renderSettings.EmptySkipping && brickTex != 0
+            && warpBound + voxelExtent <= voxelExtent * static_cast<float>(SphereVolumeData::kBrickSize);
+        uniforms.SetByName("uEnableSkipping", skipEmpty ? 1 : 0);
+        uniforms.SetByName("uBrickGrid", static_cast<int>(brickGrid));
+        uniforms.SetByName("uBricksPerUnit", static_cast<float>(volumeSize) / static_cast<float>(SphereVolumeData::kBrickSize));
+
+        // The trilinear filter reaches a voxel diagonal past the shells the builder reported.
+        auto const & shellIntervals = useGpuTexture ? _gpuVolumeBuilder.GetShellIntervals() : _volumeData.GetShellIntervals();
+        bool const clipShells = _renderSettings.ShellClipping && _shellBuffer != 0;
+        if (clipShells) {
+            ShellIntervalData shells;
+            shells.Count = static_cast<std::int32_t>(std::min(shellIntervals.size(), shells.Intervals.size()));
+            std::copy_n(shellIntervals.begin(), shells.Count, shells.Intervals.begin());
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, _shellBuffer);
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(shells), &shells);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        }
+        uniforms.SetByName("uShellClipping", clipShells ? 1 : 0);
+        float const shellPadding = warpBound + std::sqrt(3.f) * voxelExtent;
+        uniforms.SetByName("uShellPadding", shellPadding);
 
-        if (_statsBuffer) {
+        if (stats) {
             glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, _statsBuffer);
         }
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, _shellBuffer);
         if (_transferDirty) {
             UpdateTransferFunctionTexture();
         }
+        PollPreintegratedTable();
+        bool const preintegrated = _renderSettings.Preintegrated && _preintegratedReady;
+        uniforms.SetByName("uEmptyRange", _lutEmptyRange);
+        uniforms.SetByName("uPreintegrated", preintegrated ? 1 : 0);
+        bool const spectrogramEcho = _renderSettings.SpectrogramEcho > 0.f && _spectrogramTexture.GetTextureId() != 0;
+        uniforms.SetByName("uSpectrogramEcho", spectrogramEcho ? _renderSettings.SpectrogramEcho : 0.f);
+        uniforms.SetByName("uSpectrogramOffset", _spectrogram.GetWrapOffset());
+        glActiveTexture(GL_TEXTURE6);
+        glBindTexture(GL_TEXTURE_2D, spectrogramEcho ? _spectrogramTexture.GetTextureId() : 0);
+        glActiveTexture(GL_TEXTURE5);
+        glBindTexture(GL_TEXTURE_3D, _noiseTexture.Get());
+        glActiveTexture(GL_TEXTURE4);
+        glBindTexture(GL_TEXTURE_2D, _blueNoiseLoaded ? _blueNoiseTexture.Get() : 0);
+        glActiveTexture(GL_TEXTURE3);
+        glBindTexture(GL_TEXTURE_2D, preintegrated ? _preintegratedLutTexture.Get() : 0);
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_3D, brickTex);
         glActiveTexture(GL_TEXTURE1);
         glBindTexture(GL_TEXTURE_2D, _transferLutTexture.Get());
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_3D, volumeTex);
 
+        GLint targetFbo = 0;
+        if (offscreen) {
+            // Every texel of both targets is written, so they need no clear; blending waits for the upsample.
+            glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &targetFbo);
+            glBindFramebuffer(GL_FRAMEBUFFER, _volumeLowFbo.Get());
+            glViewport(0, 0, lowSize.x, lowSize.y);
+            glDisable(GL_BLEND);
+        }
         {
-            auto const progUse = _volumeProgram.Use();
+            auto const progUse = volumeProgram.Use();
             auto const vaoUse = _fullscreenVAO.Use();
             glDrawArrays(GL_TRIANGLES, 0, 3);
         }
+        if (temporal) {
+            // History is dropped on cuts: a jump of the camera or of the music would otherwise smear for frames.
+            bool const cameraJump = glm::distance(_camera.Eye, _historyEye) > kHistoryCameraJump * glm::distance(_camera.Eye, _camera.Target);
+            bool const energyJump = std::abs(_analysisState.EnergyAvg - _historyEnergy) > kHistoryEnergyJump;
+            bool const useHistory = _historyValid && !cameraJump && !energyJump;
+            std::size_t const target = _historyIndex ^ 1;
+            glBindFramebuffer(GL_FRAMEBUFFER, _volumeHistoryFbo[target].Get());
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_2D, _volumeHistory[_historyIndex].Get());
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, _volumeLowDepth.Get());
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, _volumeLowColor.Get());
+
+            auto & temporalUniforms = _volumeTemporalProgram.GetUniforms();
+            temporalUniforms.SetByName("uInvViewProj", invViewProj);
+            temporalUniforms.SetByName("uPrevViewProj", _historyViewProj);
+            temporalUniforms.SetByName("uCameraPos", _camera.Eye);
+            temporalUniforms.SetByName("uScreenSize", glm::vec2(lowSize));
+            temporalUniforms.SetByName("uBlend", std::clamp(_renderSettings.TemporalBlend, 0.02f, 1.f));
+            temporalUniforms.SetByName("uHistoryValid", useHistory ? 1 : 0);
+            {
+                auto const progUse = _volumeTemporalProgram.Use();
+                auto const vaoUse = _fullscreenVAO.Use();
+                glDrawArrays(GL_TRIANGLES, 0, 3);
+            }
+            glActiveTexture(GL_TEXTURE2);
+            glBindTexture(GL_TEXTURE_2D, 0);
+            glActiveTexture(GL_TEXTURE0);
+
+            _historyIndex = target;
+            _historyValid = true;
+            _historyViewProj = viewProj;
+            _historyEye = _camera.Eye;
+            _historyEnergy = _analysisState.EnergyAvg;
+        } else {
+            _historyValid = false;
+        }
+        if (offscreen) {
+            glEnable(GL_BLEND);
+            glBindFramebuffer(GL_FRAMEBUFFER, static_cast<GLuint>(targetFbo));
+            glViewport(0, 0, static_cast<GLsizei>(windowSize.first), static_cast<GLsizei>(windowSize.second));
+            glActiveTexture(GL_TEXTURE1);
+            glBindTexture(GL_TEXTURE_2D, _volumeLowDepth.Get());
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, temporal ? _volumeHistory[_historyIndex].Get() : _volumeLowColor.Get());
+
+            auto & upsampleUniforms = _volumeUpsampleProgram.GetUniforms();
+            upsampleUniforms.SetByName("uInvViewProj", invViewProj);
+            upsampleUniforms.SetByName("uCameraPos", _camera.Eye);
+            upsampleUniforms.SetByName("uScreenSize", screenSize);
+            upsampleUniforms.SetByName("uLowSize", glm::vec2(lowSize));
+            upsampleUniforms.SetByName("uContentRadius", shellIntervals.empty() ? 0.f : shellIntervals.back().Max + shellPadding);
+            {
+                auto const progUse = _volumeUpsampleProgram.Use();
+                auto const vaoUse = _fullscreenVAO.Use();
+                glDrawArrays(GL_TRIANGLES, 0, 3);
+            }
+            glBindTexture(GL_TEXTURE_2D, 0);
+        }
 
         glBlendFuncSeparate(prevSrcRgb, prevDstRgb, prevSrcAlpha, prevDstAlpha);
         if (!blendBefore) {
@@ -1998,24 +2657,37 @@ namespace VCX::Apps::SphereAudioVisualizer {
         glBindTexture(GL_TEXTURE_3D, 0);
         glActiveTexture(GL_TEXTURE1);
         glBindTexture(GL_TEXTURE_2D, 0);
+        glActiveTexture(GL_TEXTURE2);
+        glBindTexture(GL_TEXTURE_3D, 0);
+        glActiveTexture(GL_TEXTURE3);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glActiveTexture(GL_TEXTURE4);
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glActiveTexture(GL_TEXTURE5);
+        glBindTexture(GL_TEXTURE_3D, 0);
+        glActiveTexture(GL_TEXTURE6);
+        glBindTexture(GL_TEXTURE_2D, 0);
         glActiveTexture(GL_TEXTURE0);
-        if (_statsBuffer) {
+        if (stats) {
             glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, 0);
         }
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, 0);
 
-        glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
-
-        if (_statsBuffer) {
-            StatsData stats {};
+        // The readback stalls on the pass, so it and the per-second log only run while the stats are shown.
+        if (stats) {
+            glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT);
+            StatsData data {};
             glBindBuffer(GL_SHADER_STORAGE_BUFFER, _statsBuffer);
-            glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(stats), &stats);
+            glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(data), &data);
             glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-            _accumulatedSteps += stats.Steps;
-            _accumulatedRays += stats.Rays;
-            _accumulatedEarly += stats.EarlyExit;
+            _accumulatedSteps += data.Steps;
+            _accumulatedRays += data.Rays;
+            _accumulatedEarly += data.EarlyExit;
+            _accumulatedSkipped += data.Skipped;
+            _accumulatedMarched += data.Marched;
+            _statsTimer += deltaTime;
         }
 
-        _statsTimer += deltaTime;
         if (_statsTimer >= 1.f) {
             if (_accumulatedRays > 0) {
                 _statsSnapshot.AvgSteps = float(_accumulatedSteps) / float(_accumulatedRays);
@@ -2024,10 +2696,14 @@ namespace VCX::Apps::SphereAudioVisualizer {
                 _statsSnapshot.AvgSteps = 0.f;
                 _statsSnapshot.EarlyExitRatio = 0.f;
             }
-            spdlog::info("Raymarch avg steps {:.1f}, early exit ratio {:.1f}%", _statsSnapshot.AvgSteps, _statsSnapshot.EarlyExitRatio * 100.f);
+            auto const length = _accumulatedMarched + _accumulatedSkipped;
+            _statsSnapshot.EmptySkipRatio = length > 0 ? float(_accumulatedSkipped) / float(length) : 0.f;
+            spdlog::info("Raymarch avg steps {:.1f}, early exit ratio {:.1f}%, empty skip ratio {:.1f}%", _statsSnapshot.AvgSteps, _statsSnapshot.EarlyExitRatio * 100.f, _statsSnapshot.EmptySkipRatio * 100.f);
             _accumulatedSteps = 0;
             _accumulatedRays = 0;
             _accumulatedEarly = 0;
+            _accumulatedSkipped = 0;
+            _accumulatedMarched = 0;
             _statsTimer = 0.f;
         }
 
@@ -2063,6 +2739,13 @@ namespace VCX::Apps::SphereAudioVisualizer {
         uniforms.SetByName("u_time", _time);
         uniforms.SetByName("u_audioBass", _audioBass);
         uniforms.SetByName("u_audioTreble", _audioTreble);
+        uniforms.SetByName("u_onset", _onsetPulse[static_cast<std::size_t>(OnsetDetector::Group::High)]);
+        uniforms.SetByName("u_beatPhase", _tempoTracker.GetBeatPhase());
+        uniforms.SetByName("u_beatConfidence", _analysisSettings.OnsetEnabled ? _tempoTracker.GetConfidence() : 0.f);
+        uniforms.SetByName("u_anticipation", _anticipation);
+        auto const & descriptors = _analysisState.Descriptors;
+        uniforms.SetByName("u_spectralShape", glm::vec3(descriptors.Centroid, descriptors.Rolloff, descriptors.Flatness));
+        uniforms.SetByName("u_spectralMotion", glm::vec3(descriptors.Flux, descriptors.Crest, descriptors.ZeroCrossing));
         uniforms.SetByName("u_mode", static_cast<int>(_backgroundSettings.Mode));
         uniforms.SetByName("u_intensity", _backgroundSettings.Intensity);
         uniforms.SetByName("u_speed", _backgroundSettings.Speed);
@@ -2155,6 +2838,7 @@ namespace VCX::Apps::SphereAudioVisualizer {
             RenderVolume(deltaTime);
         } else {
             _renderMs = 0.f;
+            _historyValid = false;
         }
 
         if (_renderToggles.Sparks) {
@@ -2280,10 +2964,16 @@ namespace VCX::Apps::SphereAudioVisualizer {
             if (ImGui::SliderFloat("Global Gain", &settings.GlobalGain, 0.1f, 5.f)) {
                 settingsChanged = true;
             }
-            if (ImGui::SliderFloat("Smoothing Factor", &settings.SmoothingFactor, 0.f, 1.f)) {
+            if (ImGui::SliderFloat("Tilt (low->high)", &settings.Tilt, -1.f, 1.f)) {
                 settingsChanged = true;
             }
-            if (ImGui::SliderFloat("Tilt (low->high)", &settings.Tilt, -1.f, 1.f)) {
+            if (ImGui::SliderFloat("Stereo Pan", &settings.StereoPan, 0.f, 1.f)) {
+                settingsChanged = true;
+            }
+            if (ImGui::SliderFloat("Stereo Width", &settings.StereoWidth, 0.f, 1.f)) {
+                settingsChanged = true;
+            }
+            if (ImGui::SliderFloat("Onset Kick", &settings.OnsetKick, 0.f, 1.f)) {
                 settingsChanged = true;
             }
 
@@ -2319,10 +3009,24 @@ namespace VCX::Apps::SphereAudioVisualizer {
 
         ImGui::Separator();
         ImGui::Text("Raymarch");
-        ImGui::SliderFloat("Step Size", &_renderSettings.StepSize, 0.001f, 0.1f);
-        ImGui::SliderInt("Max Steps", &_renderSettings.MaxSteps, 16, 512);
+        ImGui::SliderFloat("Error Tolerance", &_renderSettings.ErrorTolerance, 0.002f, 0.1f, "%.3f", ImGuiSliderFlags_Logarithmic);
         ImGui::SliderFloat("Alpha Scale", &_renderSettings.AlphaScale, 0.1f, 10.f);
         ImGui::Checkbox("Enable Jitter", &_renderSettings.EnableJitter);
+        ImGui::Checkbox("Empty-Space Skipping", &_renderSettings.EmptySkipping);
+        ImGui::Checkbox("Shell Clipping", &_renderSettings.ShellClipping);
+        if (ImGui::Checkbox("Pre-integrated Transfer", &_renderSettings.Preintegrated) && _renderSettings.Preintegrated) {
+            _transferDirty = true;
+        }
+        const char * resolutionNames[] = { "Full", "Half", "Quarter" };
+        int resolutionIndex = _renderSettings.ResolutionDivisor == 4 ? 2 : (_renderSettings.ResolutionDivisor == 2 ? 1 : 0);
+        if (ImGui::Combo("Volume Resolution", &resolutionIndex, resolutionNames, IM_ARRAYSIZE(resolutionNames))) {
+            _renderSettings.ResolutionDivisor = 1 << resolutionIndex;
+        }
+        ImGui::Checkbox("Temporal Accumulation", &_renderSettings.TemporalAccumulation);
+        ImGui::BeginDisabled(!_renderSettings.TemporalAccumulation);
+        ImGui::SliderFloat("Temporal Blend", &_renderSettings.TemporalBlend, 0.02f, 1.f);
+        ImGui::EndDisabled();
+        ImGui::SliderFloat("Spectrogram Echo", &_renderSettings.SpectrogramEcho, 0.f, 4.f);
         int mode = static_cast<int>(_renderSettings.Mode);
         const char * colorModes[] = { "Grayscale", "Transfer LUT" };
         if (ImGui::Combo("Color Mode", &mode, colorModes, IM_ARRAYSIZE(colorModes))) {
@@ -2356,6 +3060,22 @@ namespace VCX::Apps::SphereAudioVisualizer {
         if (ImGui::SliderFloat("Ripple Speed", &_dynamicSettings.RippleSpeed, 0.f, 6.f)) {
             LogDynamicParam("rippleSpeed", _dynamicSettings.RippleSpeed);
         }
+        if (ImGui::TreeNode("Modulation")) {
+            const char * sourceNames[] = { "None", "Centroid", "Rolloff", "Flatness", "Flux", "Crest", "Zero Crossing" };
+            for (std::size_t i = 0; i < kModulationTargetLabels.size(); ++i) {
+                auto & route = _dynamicSettings.Modulation[i];
+                ImGui::PushID(static_cast<int>(i));
+                int source = static_cast<int>(route.Source);
+                if (ImGui::Combo(kModulationTargetLabels[i], &source, sourceNames, IM_ARRAYSIZE(sourceNames))) {
+                    route.Source = static_cast<ModulationSource>(source);
+                }
+                if (route.Source != ModulationSource::None) {
+                    ImGui::SliderFloat("Depth", &route.Depth, -1.f, 4.f);
+                }
+                ImGui::PopID();
+            }
+            ImGui::TreePop();
+        }
 
         RenderTransferFunctionUI();
 
@@ -2462,8 +3182,13 @@ namespace VCX::Apps::SphereAudioVisualizer {
             _cameraManager.Reset(_camera);
         }
 
-        ImGui::Text("Avg steps: %.1f", _statsSnapshot.AvgSteps);
-        ImGui::Text("Early exit ratio: %.1f%%", _statsSnapshot.EarlyExitRatio * 100.f);
+        _raymarchStatsVisible = ImGui::CollapsingHeader("Raymarch Stats");
+        if (_raymarchStatsVisible) {
+            ImGui::Text("Avg steps: %.1f", _statsSnapshot.AvgSteps);
+            ImGui::Text("Early exit ratio: %.1f%%", _statsSnapshot.EarlyExitRatio * 100.f);
+            ImGui::Text("Empty skip ratio: %.1f%%", _statsSnapshot.EmptySkipRatio * 100.f);
+            ImGui::Text("Volume shader variants: %zu", _volumePrograms.GetCount());
+        }
 
         ImGui::End();
     }
@@ -8,10 +8,27 @@
 
 #include <glm/glm.hpp>
 
+#include "Apps/SphereAudioVisualizer/AudioAnalysis.hpp"
 #include "Apps/SphereAudioVisualizer/SphereVolumeData.hpp"
 #include "Apps/SphereAudioVisualizer/GpuVolumeBuilder.hpp"
+#include "Apps/SphereAudioVisualizer/HarmonicPercussiveSeparator.hpp"
+#include "Apps/SphereAudioVisualizer/LoudnessMeter.hpp"
+#include "Apps/SphereAudioVisualizer/MultiResolutionSpectrum.hpp"
+#include "Apps/SphereAudioVisualizer/NoiseTexture.hpp"
 #include "Apps/SphereAudioVisualizer/AudioFilePlayer.hpp"
+#include "Apps/SphereAudioVisualizer/ChromaAnalyzer.hpp"
+#include "Apps/SphereAudioVisualizer/EnvelopeFollower.hpp"
+#include "Apps/SphereAudioVisualizer/OnsetDetector.hpp"
+#include "Apps/SphereAudioVisualizer/PreintegratedTransfer.hpp"
+#include "Apps/SphereAudioVisualizer/QuantileNormalizer.hpp"
+#include "Apps/SphereAudioVisualizer/SlidingDftSpectrum.hpp"
+#include "Apps/SphereAudioVisualizer/SpectralDescriptors.hpp"
+#include "Apps/SphereAudioVisualizer/SpectrogramHistory.hpp"
+#include "Apps/SphereAudioVisualizer/SpectrogramTexture.hpp"
+#include "Apps/SphereAudioVisualizer/StereoSpectrum.hpp"
+#include "Apps/SphereAudioVisualizer/TempoTracker.hpp"
 #include "kissfft/kiss_fft.h"
+#include "Engine/Async.hpp"
 #include "Engine/Camera.hpp"
 #include "Engine/GL/Program.h"
 #include "Engine/GL/resource.hpp"
@@ -28,40 +45,33 @@ namespace VCX::Apps::SphereAudioVisualizer {
         ~App();
         void OnFrame() override;
 
-        enum class WindowType : int { Hann, Hamming };
-        enum class MappingType : int { Linear, Log };
-        enum class AggregateType : int { Average, Max };
+        using WindowType = SphereAudioVisualizer::WindowType;
+        using MappingType = SphereAudioVisualizer::MappingType;
+        using AggregateType = SphereAudioVisualizer::AggregateType;
+        using AudioAnalysisSettings = SphereAudioVisualizer::AudioAnalysisSettings;
+
         enum class TransferPreset : int {
             Smoke = 0,
             Neon,
             Heatmap,
         };
 
-        struct AudioAnalysisSettings {
-            int FftSizeIndex = 2; // 2048 by default
-            WindowType Window = WindowType::Hann;
-            MappingType Mapping = MappingType::Log;
-            AggregateType Aggregate = AggregateType::Average;
-            int NumBands = 16;
-            float CompressK = 8.f;
-            bool ShowSpectrum = false;
-            bool AgcEnabled = true;
-            float AgcTarget = 0.8f;
-            float AgcAttack = 0.08f;   // seconds
-            float AgcRelease = 0.4f;   // seconds
-            float AgcMaxGain = 20.f;
-            float MinFrequency = 20.f;
-        };
-
         struct AudioAnalysisState {
             std::vector<float> Window;
-            std::vector<float> WindowCoeffs;
+            std::vector<float> const * WindowCoeffs = nullptr; // shared table from GetWindowCoeffs
             std::vector<float> Spectrum; // magnitude per bin (0..Nyquist)
             std::vector<float> SpectrumDownsample;
             std::vector<float> BandEnergies;
+            std::vector<float> HarmonicBands;   // BandEnergies split by HPSS; empty when it is off
+            std::vector<float> PercussiveBands;
+            SpectralDescriptors Descriptors; // updated with BandEnergies
+            std::array<float, kPitchClasses> Chroma {};
+            KeyEstimate Key;
+            std::vector<float> BandPan;   // -1 left .. 1 right per band; empty without stereo
+            std::vector<float> BandWidth; // 0 mono .. 1 out of phase per band
+            float StereoBalance = 0.f;
             std::vector<kiss_fft_cpx> FftIn;
             std::vector<kiss_fft_cpx> FftOut;
-            WindowType CachedWindow = WindowType::Hann;
             int CachedWindowSize = 0;
             float AgcGain = 1.f;
             float LastFftMs = 0.f;
@@ -71,7 +81,7 @@ namespace VCX::Apps::SphereAudioVisualizer {
             std::size_t Underruns = 0;
         };
 
-        static constexpr std::array<int, 4> kFftSizes { 512, 1024, 2048, 4096 };
+        static constexpr std::array<int, 4> kFftSizes = SphereAudioVisualizer::kFftSizes;
 
         struct SparkSettings {
             bool Enable = true;
@@ -100,11 +110,17 @@ namespace VCX::Apps::SphereAudioVisualizer {
         };
 
         struct RenderSettings {
-            float StepSize    = 0.01f;
-            int   MaxSteps    = 256;
+            float ErrorTolerance = 0.02f; // opacity change allowed per step; sets the step lengths
             float AlphaScale  = 1.f;
             ColorMode Mode    = ColorMode::Gradient;
             bool  EnableJitter = true;
+            bool  EmptySkipping = true;
+            bool  ShellClipping = true;
+            bool  Preintegrated = true; // look up segments in the pre-integrated table instead of point samples
+            int   ResolutionDivisor = 1; // 1, 2 or 4: march at a fraction of the screen and upsample
+            bool  TemporalAccumulation = true;
+            float TemporalBlend = 0.1f; // weight of the new frame in the reprojected history
+            float SpectrogramEcho = 0.f; // shell brightening from the spectrogram ring, newest at the centre
         };
 
         struct RenderToggles {
@@ -150,6 +166,7 @@ namespace VCX::Apps::SphereAudioVisualizer {
         struct StatsSnapshot {
             float AvgSteps       = 0.f;
             float EarlyExitRatio = 0.f;
+            float EmptySkipRatio = 0.f; // share of the ray length leapt over in empty space
         };
 
         enum class PerturbMode : int {
@@ -157,6 +174,23 @@ namespace VCX::Apps::SphereAudioVisualizer {
             Noise  = 1,
         };
 
+        // Dynamic parameters a spectral descriptor can modulate; order matches kModulationTargetKeys.
+        enum class ModulationTarget : int {
+            NoiseStrength,
+            NoiseFreq,
+            NoiseSpeed,
+            RippleAmp,
+            RippleFreq,
+            RippleSpeed,
+            Count,
+        };
+
+        // The parameter becomes base * (1 + Depth * source), with the source in [0, 1].
+        struct ModulationRoute {
+            ModulationSource Source = ModulationSource::None;
+            float Depth = 0.f;
+        };
+
         struct DynamicSettings {
             float NoiseStrength = 0.06f;
             float NoiseFreq     = 4.f;
@@ -165,6 +199,7 @@ namespace VCX::Apps::SphereAudioVisualizer {
             float RippleFreq    = 16.f;
             float RippleSpeed   = 1.4f;
             PerturbMode Mode    = PerturbMode::Ripple;
+            std::array<ModulationRoute, static_cast<std::size_t>(ModulationTarget::Count)> Modulation {};
         };
 
         struct TransferControlPoint {
@@ -184,6 +219,8 @@ namespace VCX::Apps::SphereAudioVisualizer {
                 TransferControlPoint{0.7f, glm::vec3(0.6f, 0.4f, 0.2f), 0.7f},
                 TransferControlPoint{1.f, glm::vec3(0.95f, 0.6f, 0.2f), 1.f},
             };
+            float KeyHue = 0.f;          // 0..1, how far the palette hue follows the key around the circle of fifths
+            bool PresetFromMode = false; // major keys pick Neon, minor keys Smoke
         };
 
         void RenderVolume(float deltaTime);
@@ -191,17 +228,24 @@ namespace VCX::Apps::SphereAudioVisualizer {
         void RenderToneMappedResult(glm::ivec2 const & size);
         bool EnsureHdrFramebuffer(glm::ivec2 const & size);
         bool EnsureBloomResources(glm::ivec2 const & size);
+        bool EnsureVolumeTargets(glm::ivec2 const & size);
         void RenderBloomPasses(glm::ivec2 const & size);
         void UpdateSparks(float deltaTime);
         void RenderSparks(glm::ivec2 const & size);
         void ResetStatsBuffer();
         void LogDynamicParam(char const * name, float value);
+        float ModulatedDynamic(ModulationTarget target, float base) const;
         void RenderAudioUI();
         void UpdateAudioAnalysis(float deltaTime);
+        void UpdateOnsets(float deltaTime);
+        void UpdateAnalysisTap();
         void RenderTransferFunctionUI();
         void UpdateTransferFunctionTexture();
+        void RequestPreintegratedTable(std::vector<glm::vec4> samples);
+        void PollPreintegratedTable();
         void ApplyTransferPreset(TransferPreset preset);
         glm::vec4 EvaluateTransferFunction(float sample) const;
+        void ApplyKeyToTransfer(KeyEstimate const & key);
         static char const * ColorModeName(ColorMode mode);
         static bool TryParseColorMode(std::string const & value, ColorMode & out);
         static char const * BackgroundModeName(BackgroundMode mode);
@@ -221,9 +265,47 @@ namespace VCX::Apps::SphereAudioVisualizer {
         AudioAnalysisSettings _analysisSettings;
         AudioAnalysisState _analysisState;
         kiss_fft_cfg _fftCfg = nullptr;
+        MultiResolutionSpectrum _multiResSpectrum;
+        SlidingDftSpectrum _slidingDft;
+        LoudnessMeter _loudnessMeter;
+        QuantileNormalizer _quantileNormalizer;
+        EnvelopeFollower _envelope;
+        SpectralDescriptorKernel _descriptorKernel;
+        HarmonicPercussiveSeparator _hpss;
+        ChromaAnalyzer _chroma;
+        StereoSpectrum _stereo;
+        std::vector<float> _stereoLeft;
+        std::vector<float> _stereoRight;
+        bool _stereoActive = false;
+        std::vector<float> _angularCoeffs; // kShCoeffs per band for the volume builders
+        float _keyHue = 0.f; // turns; relative major and minor share a hue
+        bool _hpssActive = false;
+        float _hpssMs = 0.f;
+        SpectrogramHistory _spectrogram;
+        SpectrogramTexture _spectrogramTexture;
+        std::vector<float> _spectrogramRow;
+        std::vector<float> _tapBlock;
+        std::uint64_t _tapCursor = 0; // next audio sample for the per-sample analysers
+        bool _slidingDftActive = false;
+        OnsetDetector _onsetDetector;
+        TempoTracker _tempoTracker;
+        std::vector<float> _onsetFrame;
+        std::vector<OnsetDetector::Onset> _onsetEvents;
+        std::uint64_t _onsetCursor = 0; // end sample of the next hop to analyse
+        std::array<float, OnsetDetector::kNumGroups> _onsetPulse{};
+        std::size_t _onsetsPerSecond = 0;
+        std::size_t _onsetCounter = 0;
+        bool _bassOnsetPending = false;
+        bool _featureTimelineActive = false;
+        std::size_t _featureFrame = 0;
+        std::int64_t _featureOnsetFrame = -1; // last timeline frame fed to the onset consumers
+        std::uint64_t _featureRequestedHash = 0;
+        float _featureRequestTimer = 0.f;
+        float _anticipation = 0.f; // 0..1, rises ahead of a loud section in the timeline
         TransferFunctionSettings _transferSettings;
         TransferPreset _transferPreset = TransferPreset::Smoke;
         bool _transferDirty = true;
+        glm::vec2 _lutEmptyRange { -1.f, 2.f }; // densities reading only the first LUT texel, and zero-alpha ones
         int _fftSize = kFftSizes[2];
         static constexpr std::size_t kOscilloscopeSamples = 256;
         int _audioHeadroom = kFftSizes.back();
@@ -234,9 +316,12 @@ namespace VCX::Apps::SphereAudioVisualizer {
         float _volumeLogTimer = 0.f;
         float _audioBass = 0.f;
         float _audioTreble = 0.f;
+        float _sparkBass = 0.f;   // percussive part when HPSS is on, else _audioBass
+        float _sparkTreble = 0.f;
         float _volumeBuildMs = 0.f;
         float _volumeUploadMs = 0.f;
         float _gpuBuildMs = 0.f;
+        float _descriptorMs = 0.f;
         float _renderMs = 0.f;
         float _backgroundMs = 0.f;
         float _sparkMs = 0.f;
@@ -244,11 +329,13 @@ namespace VCX::Apps::SphereAudioVisualizer {
         std::size_t _fftUpdateCounter = 0;
         std::size_t _audioReadable = 0;
         VCX::Engine::GL::UniqueProgram _backgroundProgram;
-        VCX::Engine::GL::UniqueProgram _volumeProgram;
+        VCX::Engine::GL::ProgramPermutations _volumePrograms; // keyed by shell mode, colour mode, jitter and stats
         VCX::Engine::GL::UniqueProgram _tonemapProgram;
         VCX::Engine::GL::UniqueProgram _bloomBrightProgram;
         VCX::Engine::GL::UniqueProgram _bloomBlurProgram;
         VCX::Engine::GL::UniqueProgram _sparkProgram;
+        VCX::Engine::GL::UniqueProgram _volumeUpsampleProgram;
+        VCX::Engine::GL::UniqueProgram _volumeTemporalProgram;
         VCX::Engine::GL::UniqueVertexArray _fullscreenVAO;
         VCX::Engine::GL::UniqueArrayBuffer _fullscreenVBO;
         VCX::Engine::GL::UniqueVertexArray _sparkVAO;
@@ -257,6 +344,14 @@ namespace VCX::Apps::SphereAudioVisualizer {
         VCX::Engine::Camera _camera;
         VCX::Labs::Common::OrbitCameraManager _cameraManager;
         VCX::Engine::GL::UniqueTexture2D _transferLutTexture;
+        VCX::Engine::GL::UniqueTexture2D _preintegratedLutTexture;
+        VCX::Engine::GL::UniqueTexture2D _blueNoiseTexture;
+        bool _blueNoiseLoaded = false;
+        VCX::Engine::GL::UniqueTexture3D _noiseTexture; // lattice for PerturbMode::Noise
+        bool _preintegratedReady = false;   // the texture holds a table, possibly one edit behind
+        bool _preintegrationRunning = false;
+        bool _preintegrationQueued = false; // edits arrived while the worker was busy
+        std::vector<glm::vec4> _preintegrationSamples;
         RenderSettings _renderSettings;
         RenderToggles _renderToggles;
         DynamicSettings _dynamicSettings;
@@ -265,6 +360,7 @@ namespace VCX::Apps::SphereAudioVisualizer {
         ToneMappingSettings _toneMappingSettings;
         BloomSettings _bloomSettings;
         StatsSnapshot _statsSnapshot;
+        bool _raymarchStatsVisible = false; // stats are compiled into the raymarcher only while shown
         VCX::Engine::GL::UniqueFramebuffer _hdrFbo;
         VCX::Engine::GL::UniqueRenderbuffer _hdrDepth;
         VCX::Engine::GL::UniqueTexture2D _hdrColor;
@@ -277,16 +373,30 @@ namespace VCX::Apps::SphereAudioVisualizer {
         glm::ivec2 _bloomSize { 0, 0 };
         bool _hdrFramebufferValid = false;
         bool _bloomResourcesValid = false;
+        VCX::Engine::GL::UniqueFramebuffer _volumeLowFbo;
+        VCX::Engine::GL::UniqueTexture2D _volumeLowColor;
+        VCX::Engine::GL::UniqueTexture2D _volumeLowDepth;
+        glm::ivec2 _volumeLowSize { 0, 0 };
+        bool _volumeTargetsValid = false;
+        std::array<VCX::Engine::GL::UniqueFramebuffer, 2> _volumeHistoryFbo;
+        std::array<VCX::Engine::GL::UniqueTexture2D, 2> _volumeHistory;
+        std::size_t _historyIndex = 0; // the texture holding the latest resolved frame
+        bool _historyValid = false;
+        glm::mat4 _historyViewProj { 1.f };
+        glm::vec3 _historyEye { 0.f };
+        float _historyEnergy = 0.f;
         GLuint _statsBuffer = 0;
+        GLuint _shellBuffer = 0; // ShellIntervals for the raymarcher
         GLuint _bloomTimeQuery = 0;
         float _bloomMs = 0.f;
         float _statsTimer = 0.f;
         uint64_t _accumulatedSteps = 0;
         uint64_t _accumulatedRays = 0;
         uint64_t _accumulatedEarly = 0;
+        uint64_t _accumulatedSkipped = 0;
+        uint64_t _accumulatedMarched = 0;
         uint32_t _frameIndex = 0;
         float _time = 0.f;
-        float _prevBass = 0.f;
         float _burstCooldownTimer = 0.f;
         bool _computeSupported = false;
         bool _forceCpuBuild = false;
@@ -294,6 +404,7 @@ namespace VCX::Apps::SphereAudioVisualizer {
         bool _buildOnEnergyUpdate = true;
         bool _energiesUpdatedThisFrame = false;
         uint32_t _lastBuildFrameIndex = 0;
+        VCX::Engine::Async<VCX::Engine::Texture2D<VCX::Engine::Formats::RGBA8>> _preintegrationJob; // declared last: joins first
     };
 
     void EnsureLogger();
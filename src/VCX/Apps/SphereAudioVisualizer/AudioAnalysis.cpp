@@ -0,0 +1,527 @@
+#include "Apps/SphereAudioVisualizer/AudioAnalysis.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <tuple>
+
+#include <yaml-cpp/yaml.h>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    int ClampFftIndex(int idx) {
+        return std::clamp(idx, 0, static_cast<int>(kFftSizes.size()) - 1);
+    }
+
+    int CurrentFftSize(AudioAnalysisSettings const & settings) {
+        return kFftSizes[ClampFftIndex(settings.FftSizeIndex)];
+    }
+
+    namespace {
+        constexpr std::size_t kStatLanes = 8;
+
+        // Zeroth-order modified Bessel function of the first kind, by its power series.
+        double BesselI0(double x) {
+            double const q = 0.25 * x * x;
+            double term = 1.0;
+            double sum = 1.0;
+            for (int k = 1; k < 64 && term > 1e-12 * sum; ++k) {
+                term *= q / (static_cast<double>(k) * static_cast<double>(k));
+                sum += term;
+            }
+            return sum;
+        }
+
+        // Sum of cosines a0 - a1 cos(x) + a2 cos(2x) - ...
+        template<std::size_t N>
+        double CosineSum(std::array<double, N> const & a, double phase) {
+            double value = 0.0;
+            double sign = 1.0;
+            for (std::size_t k = 0; k < N; ++k) {
+                value += sign * a[k] * std::cos(static_cast<double>(k) * phase);
+                sign = -sign;
+            }
+            return value;
+        }
+
+        void BuildWindowCoeffs(std::vector<float> & coeffs, int fftSize, WindowType type, float kaiserBeta) {
+            coeffs.resize(static_cast<std::size_t>(std::max(fftSize, 0)));
+            if (fftSize <= 1) {
+                std::fill(coeffs.begin(), coeffs.end(), 1.f);
+                return;
+            }
+            constexpr double twoPi = 6.283185307179586;
+            constexpr std::array<double, 4> blackmanHarris { 0.35875, 0.48829, 0.14128, 0.01168 };
+            constexpr std::array<double, 5> flatTop { 0.21557895, 0.41663158, 0.277263158, 0.083578947, 0.006947368 };
+            double const denom = static_cast<double>(fftSize - 1);
+            double const beta = static_cast<double>(kaiserBeta);
+            double const kaiserNorm = 1.0 / BesselI0(beta);
+            double sum = 0.0;
+            for (int i = 0; i < fftSize; ++i) {
+                double const phase = twoPi * static_cast<double>(i) / denom;
+                double value = 0.0;
+                switch (type) {
+                case WindowType::Hamming:
+                    value = 0.54 - 0.46 * std::cos(phase);
+                    break;
+                case WindowType::BlackmanHarris:
+                    value = CosineSum(blackmanHarris, phase);
+                    break;
+                case WindowType::Kaiser: {
+                    double const t = 2.0 * static_cast<double>(i) / denom - 1.0;
+                    value = BesselI0(beta * std::sqrt(std::max(0.0, 1.0 - t * t))) * kaiserNorm;
+                    break;
+                }
+                case WindowType::FlatTop:
+                    value = CosineSum(flatTop, phase);
+                    break;
+                case WindowType::Hann:
+                default:
+                    value = 0.5 * (1.0 - std::cos(phase));
+                    break;
+                }
+                coeffs[static_cast<std::size_t>(i)] = static_cast<float>(value);
+                sum += value;
+            }
+            // The newer windows are scaled to Hann's coherent gain of 0.5, so a steady tone reads the same
+            // band energy whichever of them is picked. Hann and Hamming (0.54) keep their textbook values.
+            if (type != WindowType::Hann && type != WindowType::Hamming && sum > 0.0) {
+                auto const scale = static_cast<float>(0.5 * static_cast<double>(fftSize) / sum);
+                for (auto & c : coeffs) c *= scale;
+            }
+        }
+
+        // Only Kaiser has a parameter; it is keyed in steps of 0.1 so dragging the slider cannot grow the cache without bound.
+        int WindowParamKey(WindowType type, float kaiserBeta) {
+            return type == WindowType::Kaiser ? static_cast<int>(std::lround(std::clamp(kaiserBeta, 0.f, kMaxKaiserBeta) * 10.f)) : 0;
+        }
+
+        void CenterAndWindow(
+            float * __restrict samples,
+            float const * __restrict coeffs,
+            kiss_fft_cpx * __restrict fftIn,
+            float mean,
+            std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                float const centred = samples[i] - mean;
+                samples[i] = centred;
+                fftIn[i].r = centred * coeffs[i];
+                fftIn[i].i = 0.f;
+            }
+        }
+    }
+
+    std::vector<float> const & GetWindowCoeffs(int fftSize, WindowType type, float kaiserBeta) {
+        static std::mutex mutex;
+        static std::map<std::tuple<int, int, int>, std::vector<float>> cache;
+        int const param = WindowParamKey(type, kaiserBeta);
+        std::lock_guard lock(mutex);
+        auto [it, inserted] = cache.try_emplace({ fftSize, static_cast<int>(type), param });
+        if (inserted) {
+            BuildWindowCoeffs(it->second, fftSize, type, static_cast<float>(param) * 0.1f);
+        }
+        return it->second;
+    }
+
+    void PrebuildWindowCoeffs(float kaiserBeta) {
+        for (int size : kFftSizes) {
+            for (int t = 0; t < kWindowTypeCount; ++t) {
+                GetWindowCoeffs(size, static_cast<WindowType>(t), kaiserBeta);
+            }
+        }
+    }
+
+    WindowStats MeasureWindow(float const * samples, std::size_t n) {
+        if (n == 0) return {};
+        std::array<float, kStatLanes> sum {};
+        std::array<float, kStatLanes> squares {};
+        std::size_t const blocks = n / kStatLanes;
+        for (std::size_t b = 0; b < blocks; ++b) {
+            for (std::size_t j = 0; j < kStatLanes; ++j) {
+                float const v = samples[b * kStatLanes + j];
+                sum[j] += v;
+                squares[j] += v * v;
+            }
+        }
+        float total = 0.f;
+        float totalSquares = 0.f;
+        for (std::size_t j = 0; j < kStatLanes; ++j) {
+            total += sum[j];
+            totalSquares += squares[j];
+        }
+        for (std::size_t i = blocks * kStatLanes; i < n; ++i) {
+            total += samples[i];
+            totalSquares += samples[i] * samples[i];
+        }
+        float const mean = total / static_cast<float>(n);
+        float const variance = std::max(totalSquares / static_cast<float>(n) - mean * mean, 0.f);
+        return { mean, std::sqrt(variance) };
+    }
+
+    void RemoveMean(float * samples, std::size_t n, float mean) {
+        for (std::size_t i = 0; i < n; ++i) {
+            samples[i] -= mean;
+        }
+    }
+
+    void WindowIntoFft(float * samples, float mean, std::vector<float> const & coeffs, kiss_fft_cpx * fftIn, std::size_t n) {
+        if (coeffs.size() < n) return;
+        CenterAndWindow(samples, coeffs.data(), fftIn, mean, n);
+    }
+
+    void DownsampleSpectrum(std::vector<float> const & src, std::vector<float> & dst, std::size_t target) {
+        if (target == 0 || src.empty()) {
+            dst.clear();
+            return;
+        }
+        dst.assign(target, 0.f);
+        float step = static_cast<float>(src.size()) / static_cast<float>(target);
+        for (std::size_t i = 0; i < target; ++i) {
+            std::size_t start = static_cast<std::size_t>(std::floor(step * i));
+            std::size_t end = static_cast<std::size_t>(std::floor(step * (i + 1)));
+            end = std::min(end, src.size());
+            start = std::min(start, src.size());
+            if (end <= start) continue;
+            float sum = 0.f;
+            for (std::size_t j = start; j < end; ++j) {
+                sum += src[j];
+            }
+            dst[i] = sum / static_cast<float>(end - start);
+        }
+    }
+
+    BandRange ComputeBandRange(AudioAnalysisSettings const & settings, int bandIndex, int numBands, int fftSize, int sampleRate) {
+        int half = fftSize / 2;
+        if (half <= 1) return { 0, 1 };
+        bandIndex = std::clamp(bandIndex, 0, numBands - 1);
+        if (settings.Mapping == MappingType::Linear) {
+            int start = static_cast<int>(std::floor(static_cast<float>(bandIndex) * half / numBands));
+            int end   = static_cast<int>(std::floor(static_cast<float>(bandIndex + 1) * half / numBands));
+            end = std::max(end, start + 1);
+            end = std::min(end, half);
+            return { start, end };
+        }
+
+        float nyquist = static_cast<float>(sampleRate) * 0.5f;
+        float fMin = std::max(settings.MinFrequency, 1.f);
+        float fMax = std::max(fMin, nyquist);
+        float logMin = std::log(fMin);
+        float logMax = std::log(fMax);
+        float t0 = static_cast<float>(bandIndex) / static_cast<float>(numBands);
+        float t1 = static_cast<float>(bandIndex + 1) / static_cast<float>(numBands);
+        float f0 = std::exp(logMin + (logMax - logMin) * t0);
+        float f1 = std::exp(logMin + (logMax - logMin) * t1);
+        int start = static_cast<int>(std::floor(f0 * static_cast<float>(fftSize) / static_cast<float>(sampleRate)));
+        int end   = static_cast<int>(std::ceil (f1 * static_cast<float>(fftSize) / static_cast<float>(sampleRate)));
+        start = std::clamp(start, 0, half - 1);
+        end   = std::clamp(end, start + 1, half);
+        return { start, end };
+    }
+
+    float AggregateBand(std::vector<float> const & spectrum, BandRange range, AggregateType agg) {
+        if (range.End <= range.Start || spectrum.empty()) return 0.f;
+        range.Start = std::clamp(range.Start, 0, static_cast<int>(spectrum.size()));
+        range.End = std::clamp(range.End, 0, static_cast<int>(spectrum.size()));
+        float value = 0.f;
+        if (agg == AggregateType::Max) {
+            for (int i = range.Start; i < range.End; ++i) {
+                value = std::max(value, spectrum[static_cast<std::size_t>(i)]);
+            }
+        } else {
+            float sum = 0.f;
+            for (int i = range.Start; i < range.End; ++i) {
+                sum += spectrum[static_cast<std::size_t>(i)];
+            }
+            value = sum / static_cast<float>(range.End - range.Start);
+        }
+        return value;
+    }
+
+    float ApplyCompression(float magnitude, float k) {
+        k = std::max(k, 0.f);
+        return std::log1p(k * magnitude);
+    }
+
+    float UpdateAgcGain(float currentGain, float level, AudioAnalysisSettings const & settings, float deltaTime) {
+        float target = (level > 1e-6f) ? settings.AgcTarget / level : settings.AgcMaxGain;
+        target = std::clamp(target, 1.f / settings.AgcMaxGain, settings.AgcMaxGain);
+        float tau = target > currentGain ? settings.AgcAttack : settings.AgcRelease;
+        tau = std::max(tau, 1e-3f);
+        float alpha = std::exp(-deltaTime / tau);
+        float updated = alpha * currentGain + (1.f - alpha) * target;
+        return std::clamp(updated, 1.f / settings.AgcMaxGain, settings.AgcMaxGain);
+    }
+
+    char const * WindowTypeName(WindowType type) {
+        switch (type) {
+        case WindowType::Hamming:
+            return "Hamming";
+        case WindowType::BlackmanHarris:
+            return "BlackmanHarris";
+        case WindowType::Kaiser:
+            return "Kaiser";
+        case WindowType::FlatTop:
+            return "FlatTop";
+        case WindowType::Hann:
+        default:
+            return "Hann";
+        }
+    }
+
+    bool TryParseWindowType(std::string const & value, WindowType & out) {
+        for (int i = 0; i < kWindowTypeCount; ++i) {
+            auto const type = static_cast<WindowType>(i);
+            if (value == WindowTypeName(type)) {
+                out = type;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    char const * MappingTypeName(MappingType type) {
+        switch (type) {
+        case MappingType::Log:
+            return "Log";
+        case MappingType::Linear:
+        default:
+            return "Linear";
+        }
+    }
+
+    bool TryParseMappingType(std::string const & value, MappingType & out) {
+        if (value == "Log") {
+            out = MappingType::Log;
+            return true;
+        }
+        if (value == "Linear") {
+            out = MappingType::Linear;
+            return true;
+        }
+        return false;
+    }
+
+    char const * AgcSourceName(AgcSource source) {
+        switch (source) {
+        case AgcSource::Loudness:
+            return "Loudness";
+        case AgcSource::PeakBand:
+        default:
+            return "PeakBand";
+        }
+    }
+
+    bool TryParseAgcSource(std::string const & value, AgcSource & out) {
+        if (value == "PeakBand") {
+            out = AgcSource::PeakBand;
+            return true;
+        }
+        if (value == "Loudness") {
+            out = AgcSource::Loudness;
+            return true;
+        }
+        return false;
+    }
+
+    char const * BandNormalizationName(BandNormalization mode) {
+        switch (mode) {
+        case BandNormalization::Quantile:
+            return "Quantile";
+        case BandNormalization::Agc:
+        default:
+            return "Agc";
+        }
+    }
+
+    bool TryParseBandNormalization(std::string const & value, BandNormalization & out) {
+        if (value == "Agc") {
+            out = BandNormalization::Agc;
+            return true;
+        }
+        if (value == "Quantile") {
+            out = BandNormalization::Quantile;
+            return true;
+        }
+        return false;
+    }
+
+    char const * SlidingDftModeName(SlidingDftMode mode) {
+        switch (mode) {
+        case SlidingDftMode::On:
+            return "On";
+        case SlidingDftMode::Auto:
+            return "Auto";
+        case SlidingDftMode::Off:
+        default:
+            return "Off";
+        }
+    }
+
+    bool TryParseSlidingDftMode(std::string const & value, SlidingDftMode & out) {
+        if (value == "Off") {
+            out = SlidingDftMode::Off;
+            return true;
+        }
+        if (value == "On") {
+            out = SlidingDftMode::On;
+            return true;
+        }
+        if (value == "Auto") {
+            out = SlidingDftMode::Auto;
+            return true;
+        }
+        return false;
+    }
+
+    void ReadAnalysisSettings(YAML::Node const & node, AudioAnalysisSettings & settings) {
+        if (auto fftNode = node["fftSize"]) {
+            int const fftSize = fftNode.as<int>(CurrentFftSize(settings));
+            auto const iter = std::find(kFftSizes.begin(), kFftSizes.end(), fftSize);
+            if (iter != kFftSizes.end()) {
+                settings.FftSizeIndex = static_cast<int>(std::distance(kFftSizes.begin(), iter));
+            }
+        }
+        settings.NumBands = node["numBands"].as<int>(settings.NumBands);
+        settings.NumBands = std::clamp(settings.NumBands, 1, 256);
+        settings.MultiResolution = node["multiResolution"].as<bool>(settings.MultiResolution);
+        if (auto slidingNode = node["slidingDft"]) {
+            SlidingDftMode mode;
+            if (TryParseSlidingDftMode(slidingNode.as<std::string>(), mode)) {
+                settings.SlidingDft = mode;
+            }
+        }
+        if (auto windowNode = node["windowType"]) {
+            WindowType type;
+            if (TryParseWindowType(windowNode.as<std::string>(), type)) {
+                settings.Window = type;
+            }
+        }
+        settings.KaiserBeta = std::clamp(node["kaiserBeta"].as<float>(settings.KaiserBeta), 0.f, kMaxKaiserBeta);
+        if (auto mappingNode = node["mappingType"]) {
+            MappingType mapping;
+            if (TryParseMappingType(mappingNode.as<std::string>(), mapping)) {
+                settings.Mapping = mapping;
+            }
+        }
+        settings.CompressK = node["compressK"].as<float>(settings.CompressK);
+        if (auto agcNode = node["agc"]) {
+            settings.AgcEnabled = agcNode["enabled"].as<bool>(settings.AgcEnabled);
+            if (auto sourceNode = agcNode["source"]) {
+                AgcSource source;
+                if (TryParseAgcSource(sourceNode.as<std::string>(), source)) {
+                    settings.AgcLevelSource = source;
+                }
+            }
+            settings.AgcTarget = agcNode["target"].as<float>(settings.AgcTarget);
+            settings.AgcAttack = agcNode["attack"].as<float>(settings.AgcAttack);
+            settings.AgcRelease = agcNode["release"].as<float>(settings.AgcRelease);
+            settings.AgcMaxGain = agcNode["maxGain"].as<float>(settings.AgcMaxGain);
+        }
+        if (auto normalizationNode = node["normalization"]) {
+            if (auto modeNode = normalizationNode["mode"]) {
+                BandNormalization mode;
+                if (TryParseBandNormalization(modeNode.as<std::string>(), mode)) {
+                    settings.Normalization = mode;
+                }
+            }
+            settings.QuantileLow = normalizationNode["low"].as<float>(settings.QuantileLow);
+            settings.QuantileHigh = normalizationNode["high"].as<float>(settings.QuantileHigh);
+            settings.QuantileWindow = normalizationNode["window"].as<float>(settings.QuantileWindow);
+        }
+        if (auto envelopeNode = node["envelope"]) {
+            settings.EnvelopeAttackLow = envelopeNode["attackLow"].as<float>(settings.EnvelopeAttackLow);
+            settings.EnvelopeAttackHigh = envelopeNode["attackHigh"].as<float>(settings.EnvelopeAttackHigh);
+            settings.EnvelopeReleaseLow = envelopeNode["releaseLow"].as<float>(settings.EnvelopeReleaseLow);
+            settings.EnvelopeReleaseHigh = envelopeNode["releaseHigh"].as<float>(settings.EnvelopeReleaseHigh);
+            settings.PeakHold = envelopeNode["peakHold"].as<bool>(settings.PeakHold);
+            settings.PeakHoldSeconds = envelopeNode["holdSeconds"].as<float>(settings.PeakHoldSeconds);
+            settings.PeakDecaySeconds = envelopeNode["peakDecay"].as<float>(settings.PeakDecaySeconds);
+        }
+        if (auto hpssNode = node["hpss"]) {
+            settings.HpssEnabled = hpssNode["enabled"].as<bool>(settings.HpssEnabled);
+            settings.HpssTimeFrames = hpssNode["timeFrames"].as<int>(settings.HpssTimeFrames);
+            settings.HpssFreqBins = hpssNode["freqBins"].as<int>(settings.HpssFreqBins);
+        }
+        if (auto stereoNode = node["stereo"]) {
+            settings.StereoEnabled = stereoNode["enabled"].as<bool>(settings.StereoEnabled);
+        }
+        if (auto chromaNode = node["chroma"]) {
+            settings.ChromaEnabled = chromaNode["enabled"].as<bool>(settings.ChromaEnabled);
+            settings.ChromaKeyInterval = chromaNode["keyInterval"].as<int>(settings.ChromaKeyInterval);
+            settings.ChromaKeySeconds = chromaNode["keySeconds"].as<float>(settings.ChromaKeySeconds);
+        }
+        if (auto onsetNode = node["onset"]) {
+            settings.OnsetEnabled = onsetNode["enabled"].as<bool>(settings.OnsetEnabled);
+            settings.OnsetSensitivity = onsetNode["sensitivity"].as<float>(settings.OnsetSensitivity);
+            settings.OnsetMinInterval = onsetNode["minInterval"].as<float>(settings.OnsetMinInterval);
+        }
+        if (auto tempoNode = node["tempo"]) {
+            settings.TempoPriorBpm = tempoNode["priorBpm"].as<float>(settings.TempoPriorBpm);
+        }
+        if (auto timelineNode = node["timeline"]) {
+            settings.UseFeatureTimeline = timelineNode["enabled"].as<bool>(settings.UseFeatureTimeline);
+            settings.LookaheadSeconds = timelineNode["lookahead"].as<float>(settings.LookaheadSeconds);
+        }
+    }
+
+    YAML::Node WriteAnalysisSettings(AudioAnalysisSettings const & settings) {
+        YAML::Node node;
+        node["fftSize"] = CurrentFftSize(settings);
+        node["numBands"] = settings.NumBands;
+        node["multiResolution"] = settings.MultiResolution;
+        node["slidingDft"] = SlidingDftModeName(settings.SlidingDft);
+        node["windowType"] = WindowTypeName(settings.Window);
+        node["kaiserBeta"] = settings.KaiserBeta;
+        node["mappingType"] = MappingTypeName(settings.Mapping);
+        node["compressK"] = settings.CompressK;
+        YAML::Node agcNode;
+        agcNode["enabled"] = settings.AgcEnabled;
+        agcNode["source"] = AgcSourceName(settings.AgcLevelSource);
+        agcNode["target"] = settings.AgcTarget;
+        agcNode["attack"] = settings.AgcAttack;
+        agcNode["release"] = settings.AgcRelease;
+        agcNode["maxGain"] = settings.AgcMaxGain;
+        node["agc"] = agcNode;
+        YAML::Node normalizationNode;
+        normalizationNode["mode"] = BandNormalizationName(settings.Normalization);
+        normalizationNode["low"] = settings.QuantileLow;
+        normalizationNode["high"] = settings.QuantileHigh;
+        normalizationNode["window"] = settings.QuantileWindow;
+        node["normalization"] = normalizationNode;
+        YAML::Node envelopeNode;
+        envelopeNode["attackLow"] = settings.EnvelopeAttackLow;
+        envelopeNode["attackHigh"] = settings.EnvelopeAttackHigh;
+        envelopeNode["releaseLow"] = settings.EnvelopeReleaseLow;
+        envelopeNode["releaseHigh"] = settings.EnvelopeReleaseHigh;
+        envelopeNode["peakHold"] = settings.PeakHold;
+        envelopeNode["holdSeconds"] = settings.PeakHoldSeconds;
+        envelopeNode["peakDecay"] = settings.PeakDecaySeconds;
+        node["envelope"] = envelopeNode;
+        YAML::Node hpssNode;
+        hpssNode["enabled"] = settings.HpssEnabled;
+        hpssNode["timeFrames"] = settings.HpssTimeFrames;
+        hpssNode["freqBins"] = settings.HpssFreqBins;
+        node["hpss"] = hpssNode;
+        YAML::Node stereoNode;
+        stereoNode["enabled"] = settings.StereoEnabled;
+        node["stereo"] = stereoNode;
+        YAML::Node chromaNode;
+        chromaNode["enabled"] = settings.ChromaEnabled;
+        chromaNode["keyInterval"] = settings.ChromaKeyInterval;
+        chromaNode["keySeconds"] = settings.ChromaKeySeconds;
+        node["chroma"] = chromaNode;
+        YAML::Node onsetNode;
+        onsetNode["enabled"] = settings.OnsetEnabled;
+        onsetNode["sensitivity"] = settings.OnsetSensitivity;
+        onsetNode["minInterval"] = settings.OnsetMinInterval;
+        node["onset"] = onsetNode;
+        YAML::Node tempoNode;
+        tempoNode["priorBpm"] = settings.TempoPriorBpm;
+        node["tempo"] = tempoNode;
+        YAML::Node timelineNode;
+        timelineNode["enabled"] = settings.UseFeatureTimeline;
+        timelineNode["lookahead"] = settings.LookaheadSeconds;
+        node["timeline"] = timelineNode;
+        return node;
+    }
+} // namespace VCX::Apps::SphereAudioVisualizer
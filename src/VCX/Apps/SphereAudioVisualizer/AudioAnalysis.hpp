@@ -0,0 +1,109 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "kissfft/kiss_fft.h"
+
+namespace YAML {
+    class Node;
+}
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    enum class WindowType : int { Hann, Hamming, BlackmanHarris, Kaiser, FlatTop };
+    inline constexpr int kWindowTypeCount = 5;
+    inline constexpr float kMaxKaiserBeta = 20.f;
+    enum class MappingType : int { Linear, Log };
+    enum class AggregateType : int { Average, Max };
+    enum class SlidingDftMode : int { Off, On, Auto }; // Auto: pick the cheaper of sliding DFT and FFT
+    enum class AgcSource : int { PeakBand, Loudness };  // what the AGC normalises: loudest band or short-term LUFS
+    enum class BandNormalization : int { Agc, Quantile }; // one shared AGC gain, or each band by its own recent range
+
+    inline constexpr std::array<int, 4> kFftSizes { 512, 1024, 2048, 4096 };
+
+    struct AudioAnalysisSettings {
+        int FftSizeIndex = 2; // 2048 by default
+        WindowType Window = WindowType::Hann;
+        float KaiserBeta = 8.6f; // Kaiser window shape: larger trades a wider main lobe for lower sidelobes
+        MappingType Mapping = MappingType::Log;
+        AggregateType Aggregate = AggregateType::Average;
+        int NumBands = 16;
+        bool MultiResolution = false; // per-band FFT sizes (MultiResolutionSpectrum) instead of FftSizeIndex
+        SlidingDftMode SlidingDft = SlidingDftMode::Off; // per-sample resonators (SlidingDftSpectrum) for the live bands
+        float CompressK = 8.f;
+        bool ShowSpectrum = false;
+        bool AgcEnabled = true;
+        AgcSource AgcLevelSource = AgcSource::PeakBand;
+        float AgcTarget = 0.8f;
+        float AgcAttack = 0.08f;   // seconds
+        float AgcRelease = 0.4f;   // seconds
+        float AgcMaxGain = 20.f;
+        BandNormalization Normalization = BandNormalization::Agc;
+        float QuantileLow = 0.05f;
+        float QuantileHigh = 0.95f;
+        float QuantileWindow = 10.f;       // seconds of history behind the quantiles
+        float EnvelopeAttackLow = 0.02f;   // seconds, lowest band; bands in between are interpolated
+        float EnvelopeAttackHigh = 0.01f;  // seconds, highest band
+        float EnvelopeReleaseLow = 0.25f;
+        float EnvelopeReleaseHigh = 0.12f;
+        bool PeakHold = false;
+        float PeakHoldSeconds = 0.15f;
+        float PeakDecaySeconds = 0.4f;     // time constant of the fall after the hold
+        bool HpssEnabled = false;          // shells from the harmonic part, sparks from the percussive part
+        int HpssTimeFrames = 17;           // median length over time (frames), odd
+        int HpssFreqBins = 17;             // median length over frequency (bins), odd
+        bool StereoEnabled = false;        // per-band pan and width from one packed L/R transform (single-FFT path)
+        bool ChromaEnabled = true;         // 12-bin chroma and key estimate from the FFT spectrum
+        int ChromaKeyInterval = 16;        // analysis frames between key estimates
+        float ChromaKeySeconds = 8.f;      // time constant of the chroma the key is estimated from
+        float MinFrequency = 20.f;
+        bool OnsetEnabled = true;
+        float OnsetSensitivity = 1.5f;
+        float OnsetMinInterval = 0.1f; // seconds
+        float TempoPriorBpm = 120.f;
+        bool UseFeatureTimeline = true; // look features up in the offline timeline when it is ready
+        float LookaheadSeconds = 2.f;
+    };
+
+    struct BandRange {
+        int Start;
+        int End; // exclusive
+    };
+
+    // Shared by the live analysis in App and the offline feature timeline, so both produce the same features.
+    int ClampFftIndex(int idx);
+    int CurrentFftSize(AudioAnalysisSettings const & settings);
+    // Window tables are built once per (size, type, Kaiser beta) and shared across threads; the reference stays valid.
+    std::vector<float> const & GetWindowCoeffs(int fftSize, WindowType type, float kaiserBeta);
+    void PrebuildWindowCoeffs(float kaiserBeta); // every type at every kFftSizes entry
+    struct WindowStats {
+        float Mean = 0.f;
+        float Rms = 0.f; // of the samples with the mean removed
+    };
+    WindowStats MeasureWindow(float const * samples, std::size_t n);
+    void RemoveMean(float * samples, std::size_t n, float mean);
+    // Removes the mean in place and writes the windowed samples straight into the FFT input, in one pass.
+    void WindowIntoFft(float * samples, float mean, std::vector<float> const & coeffs, kiss_fft_cpx * fftIn, std::size_t n);
+    void DownsampleSpectrum(std::vector<float> const & src, std::vector<float> & dst, std::size_t target);
+    BandRange ComputeBandRange(AudioAnalysisSettings const & settings, int bandIndex, int numBands, int fftSize, int sampleRate);
+    float AggregateBand(std::vector<float> const & spectrum, BandRange range, AggregateType agg);
+    float ApplyCompression(float magnitude, float k);
+    float UpdateAgcGain(float currentGain, float level, AudioAnalysisSettings const & settings, float deltaTime);
+    char const * WindowTypeName(WindowType type);
+    bool TryParseWindowType(std::string const & value, WindowType & out);
+    char const * MappingTypeName(MappingType type);
+    bool TryParseMappingType(std::string const & value, MappingType & out);
+    char const * AgcSourceName(AgcSource source);
+    bool TryParseAgcSource(std::string const & value, AgcSource & out);
+    char const * BandNormalizationName(BandNormalization mode);
+    bool TryParseBandNormalization(std::string const & value, BandNormalization & out);
+    char const * SlidingDftModeName(SlidingDftMode mode);
+    bool TryParseSlidingDftMode(std::string const & value, SlidingDftMode & out);
+
+    // The "analysis" section of SphereVisConfig.yaml; also read by the batch analyzer.
+    void ReadAnalysisSettings(YAML::Node const & node, AudioAnalysisSettings & settings);
+    YAML::Node WriteAnalysisSettings(AudioAnalysisSettings const & settings);
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -9,6 +9,7 @@
 #include <algorithm>
 #include <cmath>
 #include <cstring>
+#include <limits>
 
 #include <spdlog/spdlog.h>
 
@@ -17,6 +18,8 @@ namespace VCX::Apps::SphereAudioVisualizer {
         constexpr std::uint32_t kDefaultSampleRate = 48000;
         constexpr std::uint32_t kDefaultChannels   = 2;
         constexpr std::uint32_t kRingSeconds       = 4; // ring holds ~4 seconds of mono audio
+        constexpr ma_uint32     kDecodeChunkFrames = 4096; // decoder reads per step; sizes _stereoScratch
+        constexpr std::uint64_t kNoStereo          = std::numeric_limits<std::uint64_t>::max();
     }
 
     AudioFilePlayer::AudioFilePlayer() {
@@ -25,11 +28,13 @@ namespace VCX::Apps::SphereAudioVisualizer {
     }
 
     AudioFilePlayer::~AudioFilePlayer() {
+        _featureCancel.store(true);
         StopDevice();
         if (_decoderInit) {
             ma_decoder_uninit(&_decoder);
         }
         _ring.clear();
+        _stereoRing.clear();
     }
 
     bool AudioFilePlayer::IsLoaded() const { return _loaded.load(); }
@@ -63,6 +68,9 @@ namespace VCX::Apps::SphereAudioVisualizer {
     void AudioFilePlayer::ResetRing(std::uint32_t sampleRate) {
         _ringCapacity = std::max<std::size_t>(sampleRate * kRingSeconds, std::size_t(1024));
         _ring.assign(_ringCapacity, 0.f);
+        _stereoRing.assign(_ringCapacity * 2, 0.f);
+        _stereoFrom.store(kNoStereo);
+        _stereoWriting = false;
         _ringWrite.store(0);
         _ringRead.store(0);
         _overrunWrites.store(0);
@@ -112,6 +120,17 @@ namespace VCX::Apps::SphereAudioVisualizer {
     }
 
     bool AudioFilePlayer::LoadFile(std::string const & path) {
+        // The previous track's timeline job is cancelled and joined before _mutex is taken, so the load never
+        // waits on a worker mid-decode while holding it.
+        _featureCancel.store(true);
+        _featureJob.Reset();
+        _featureJobRunning = false;
+        if (!LoadDecoder(path)) return false;
+        RequestFeatureTimeline();
+        return true;
+    }
+
+    bool AudioFilePlayer::LoadDecoder(std::string const & path) {
         std::scoped_lock lock(_mutex);
         _path = path;
         _lastError.clear();
@@ -138,6 +157,7 @@ namespace VCX::Apps::SphereAudioVisualizer {
             ResetRing(_sampleRate);
             ResetDecoderState();
             StartDevice();
+            _featureTimeline.Close();
             return false;
         }
 
@@ -147,6 +167,7 @@ namespace VCX::Apps::SphereAudioVisualizer {
         ma_decoder_get_length_in_pcm_frames(&_decoder, &_totalFrames);
         ResetRing(_sampleRate);
         ResetDecoderState();
+        _stereoScratch.assign(std::size_t(kDecodeChunkFrames) * 2, 0.f);
         _useSine.store(false);
         _loaded.store(true);
         _paused.store(true);
@@ -162,6 +183,64 @@ namespace VCX::Apps::SphereAudioVisualizer {
         return deviceOk;
     }
 
+    void AudioFilePlayer::SetFeatureSettings(AudioAnalysisSettings const & settings) {
+        _featureSettings = settings;
+    }
+
+    void AudioFilePlayer::RequestFeatureTimeline() {
+        _featureTimeline.Close();
+        _featureError.clear();
+        if (!_loaded.load() || _path.empty()) return;
+
+        // A previous job for another file or other settings is abandoned; Reset joins it.
+        _featureCancel.store(true);
+        _featureJob.Reset();
+        _featureCancel.store(false);
+
+        auto const cachePath = FeatureTimeline::CachePathFor(_path, _featureSettings);
+        if (_featureTimeline.Open(cachePath) && _featureTimeline.GetSettingsHash() == FeatureTimeline::HashSettings(_featureSettings)) {
+            _featureProgress.store(1.f);
+            _featureJobRunning = false;
+            spdlog::info("Feature timeline mapped from cache {}", cachePath.string());
+            return;
+        }
+        _featureTimeline.Close();
+
+        _featureProgress.store(0.f);
+        _featureJobRunning = true;
+        _featureJob.Emplace([source = std::filesystem::path(_path), cachePath, settings = _featureSettings, this]() {
+            FeatureJobResult result;
+            if (FeatureTimeline::Build(source, cachePath, settings, &_featureCancel, &_featureProgress, &result.Stats, result.Error)) {
+                result.Path = cachePath;
+            }
+            return result;
+        });
+    }
+
+    void AudioFilePlayer::PollFeatureTimeline() {
+        if (!_featureJobRunning || !_featureJob.IsCompleted()) return;
+        _featureJobRunning = false;
+        auto const & result = _featureJob.Value();
+        if (result.Path.empty()) {
+            _featureError = result.Error;
+            if (result.Error != "cancelled") {
+                spdlog::warn("Feature timeline failed for {}: {}", _path, result.Error);
+            }
+            return;
+        }
+        if (!_featureTimeline.Open(result.Path)) {
+            _featureError = "Failed to map " + result.Path.string();
+            spdlog::warn("{}", _featureError);
+            return;
+        }
+        spdlog::info("Feature timeline ready: {:.1f}s of audio in {:.2f}s (decode {:.2f}s), {} frames, {} onsets",
+            result.Stats.AudioSeconds,
+            result.Stats.DecodeSeconds + result.Stats.AnalysisSeconds,
+            result.Stats.DecodeSeconds,
+            result.Stats.Frames,
+            result.Stats.Onsets);
+    }
+
     void AudioFilePlayer::Play() {
         if (!_deviceInit) {
             if (!StartDevice()) return;
@@ -187,6 +266,10 @@ namespace VCX::Apps::SphereAudioVisualizer {
         _monoMixMode.store(monoMix);
     }
 
+    void AudioFilePlayer::SetStereoCapture(bool capture) {
+        _stereoCapture.store(capture);
+    }
+
     bool AudioFilePlayer::GetMonoMixMode() const {
         return _monoMixMode.load();
     }
@@ -207,6 +290,12 @@ namespace VCX::Apps::SphereAudioVisualizer {
             return;
         }
 
+        bool const stereoCapture = _stereoCapture.load();
+        if (stereoCapture != _stereoWriting) {
+            _stereoWriting = stereoCapture;
+            _stereoFrom.store(stereoCapture ? _ringWrite.load(std::memory_order_relaxed) : kNoStereo, std::memory_order_release);
+        }
+
         if (_useSine.load() || !_decoderInit) {
             // Sine fallback
             float freq = 220.f;
@@ -225,7 +314,7 @@ namespace VCX::Apps::SphereAudioVisualizer {
             for (ma_uint32 i = 0; i < frameCount; ++i) {
                 _scratch[i] = output[i * channels];
             }
-            WriteRing(_scratch.data(), frameCount);
+            WriteRing(_scratch.data(), nullptr, frameCount);
             _cursorFrames.fetch_add(frameCount, std::memory_order_relaxed);
             return;
         }
@@ -234,7 +323,7 @@ namespace VCX::Apps::SphereAudioVisualizer {
         float *   outPtr = output;
         while (framesRemaining > 0) {
             ma_uint64 framesRead64 = 0;
-            ma_result res = ma_decoder_read_pcm_frames(&_decoder, outPtr, framesRemaining, &framesRead64);
+            ma_result res = ma_decoder_read_pcm_frames(&_decoder, outPtr, std::min(framesRemaining, kDecodeChunkFrames), &framesRead64);
             ma_uint32 framesRead = static_cast<ma_uint32>(framesRead64);
             if (res != MA_SUCCESS && framesRead == 0) {
                 // Decoder error; fallback to silence and pause.
@@ -253,10 +342,15 @@ namespace VCX::Apps::SphereAudioVisualizer {
                 }
             }
 
-            // Write mono samples to ring buffer
+            // Write mono samples to ring buffer, and the first two channels next to them while capturing stereo
             _scratch.resize(framesRead);
+            bool const stereo = _stereoWriting && channels > 0;
             bool const monoMix = _monoMixMode.load();
             for (ma_uint32 i = 0; i < framesRead; ++i) {
+                if (stereo) {
+                    _stereoScratch[i * 2] = outPtr[i * channels];
+                    _stereoScratch[i * 2 + 1] = outPtr[i * channels + (channels > 1 ? 1 : 0)];
+                }
                 float value = 0.f;
                 if (monoMix) {
                     float accum = 0.f;
@@ -269,7 +363,7 @@ namespace VCX::Apps::SphereAudioVisualizer {
                 }
                 _scratch[i] = value;
             }
-            WriteRing(_scratch.data(), framesRead);
+            WriteRing(_scratch.data(), stereo ? _stereoScratch.data() : nullptr, framesRead);
 
             outPtr += std::size_t(framesRead) * channels;
             framesRemaining -= framesRead;
@@ -287,7 +381,7 @@ namespace VCX::Apps::SphereAudioVisualizer {
         return write - read;
     }
 
-    void AudioFilePlayer::WriteRing(const float * samples, std::size_t frames) {
+    void AudioFilePlayer::WriteRing(const float * samples, const float * stereo, std::size_t frames) {
         if (_ringCapacity == 0 || frames == 0) return;
         std::size_t write = _ringWrite.load(std::memory_order_relaxed);
         std::size_t read  = _ringRead.load(std::memory_order_acquire);
@@ -305,7 +399,15 @@ namespace VCX::Apps::SphereAudioVisualizer {
 
         std::size_t start = frames > toWrite ? frames - toWrite : 0;
         for (std::size_t i = 0; i < toWrite; ++i) {
-            _ring[(write + i) % _ringCapacity] = samples[start + i];
+            std::size_t const slot = (write + i) % _ringCapacity;
+            _ring[slot] = samples[start + i];
+        }
+        if (_stereoWriting) {
+            for (std::size_t i = 0; i < toWrite; ++i) {
+                std::size_t const slot = (write + i) % _ringCapacity;
+                _stereoRing[slot * 2] = stereo ? stereo[(start + i) * 2] : samples[start + i];
+                _stereoRing[slot * 2 + 1] = stereo ? stereo[(start + i) * 2 + 1] : samples[start + i];
+            }
         }
         _ringWrite.store(write + toWrite, std::memory_order_release);
     }
@@ -356,6 +458,45 @@ namespace VCX::Apps::SphereAudioVisualizer {
         return toCopy;
     }
 
+    std::uint64_t AudioFilePlayer::GetWrittenSamples() const {
+        return _ringWrite.load(std::memory_order_acquire);
+    }
+
+    bool AudioFilePlayer::CopyWindowAt(float * dst, std::size_t count, std::uint64_t endSample) const {
+        if (dst == nullptr || count == 0 || _ringCapacity == 0 || count > _ringCapacity) return false;
+        if (endSample < count) return false;
+        std::uint64_t const write = _ringWrite.load(std::memory_order_acquire);
+        if (endSample > write || write - (endSample - count) > _ringCapacity) return false;
+
+        std::size_t const start = static_cast<std::size_t>((endSample - count) % _ringCapacity);
+        std::size_t const firstChunk = std::min(count, _ringCapacity - start);
+        std::memcpy(dst, _ring.data() + start, firstChunk * sizeof(float));
+        if (firstChunk < count) {
+            std::memcpy(dst + firstChunk, _ring.data(), (count - firstChunk) * sizeof(float));
+        }
+
+        // The writer may have lapped the range while we were copying.
+        std::uint64_t const writeAfter = _ringWrite.load(std::memory_order_acquire);
+        return writeAfter - (endSample - count) <= _ringCapacity;
+    }
+
+    bool AudioFilePlayer::CopyStereoWindowAt(float * left, float * right, std::size_t count, std::uint64_t endSample) const {
+        if (left == nullptr || right == nullptr || count == 0 || _ringCapacity == 0 || count > _ringCapacity) return false;
+        if (endSample < count || endSample - count < _stereoFrom.load(std::memory_order_acquire)) return false;
+        std::uint64_t const write = _ringWrite.load(std::memory_order_acquire);
+        if (endSample > write || write - (endSample - count) > _ringCapacity) return false;
+
+        std::size_t const start = static_cast<std::size_t>((endSample - count) % _ringCapacity);
+        for (std::size_t i = 0; i < count; ++i) {
+            std::size_t const slot = (start + i) % _ringCapacity;
+            left[i] = _stereoRing[slot * 2];
+            right[i] = _stereoRing[slot * 2 + 1];
+        }
+
+        std::uint64_t const writeAfter = _ringWrite.load(std::memory_order_acquire);
+        return writeAfter - (endSample - count) <= _ringCapacity;
+    }
+
     void AudioFilePlayer::DiscardSamples(std::size_t count) {
         if (count == 0) return;
         std::size_t available = RingReadable();
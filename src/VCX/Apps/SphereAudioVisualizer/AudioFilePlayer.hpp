@@ -2,12 +2,17 @@
 
 #include <atomic>
 #include <cstdint>
+#include <filesystem>
 #include <mutex>
 #include <string>
 #include <vector>
 
 #include <miniaudio.h>
 
+#include "Apps/SphereAudioVisualizer/AudioAnalysis.hpp"
+#include "Apps/SphereAudioVisualizer/FeatureTimeline.hpp"
+#include "Engine/Async.hpp"
+
 namespace VCX::Apps::SphereAudioVisualizer {
     class AudioFilePlayer {
     public:
@@ -20,6 +25,8 @@ namespace VCX::Apps::SphereAudioVisualizer {
         void Stop();
         void SetLoop(bool loop);
         void SetMonoMixMode(bool monoMix);
+        // Keep the left/right ring filled for CopyStereoWindowAt; off by default, as it triples the ring writes.
+        void SetStereoCapture(bool capture);
 
         bool IsLoaded() const;
         bool IsPlaying() const;
@@ -50,15 +57,55 @@ namespace VCX::Apps::SphereAudioVisualizer {
          */
         std::size_t GetLatestWindow(float * dst, std::size_t fftSize, std::size_t headroom);
 
+        /**
+         * Total mono samples written to the analysis ring since the last load; used as the audio-sample clock.
+         */
+        std::uint64_t GetWrittenSamples() const;
+
+        /**
+         * Copy count samples ending at absolute sample position endSample (exclusive) without advancing the read cursor.
+         * @return false if the range is not written yet or has already been overwritten.
+         */
+        bool CopyWindowAt(float * dst, std::size_t count, std::uint64_t endSample) const;
+
+        /**
+         * Like CopyWindowAt, for the left and right channels kept next to the mono ring (both equal for mono sources).
+         * Fails while stereo capture is off or for ranges written before it was turned on.
+         */
+        bool CopyStereoWindowAt(float * left, float * right, std::size_t count, std::uint64_t endSample) const;
+
         std::string const & GetLastError() const;
 
+        /**
+         * Settings used by the offline feature timeline; LoadFile starts analysing the whole track with them
+         * on a background job, or maps a cached timeline built with the same settings.
+         */
+        void SetFeatureSettings(AudioAnalysisSettings const & settings);
+        /** Re-run the offline analysis of the loaded file, e.g. after the feature settings changed. */
+        void RequestFeatureTimeline();
+        /** Map the timeline once the background job has finished. Call once per frame from the render thread. */
+        void PollFeatureTimeline();
+        FeatureTimeline const & GetFeatureTimeline() const { return _featureTimeline; }
+        bool IsFeatureJobRunning() const { return _featureJobRunning; }
+        float GetFeatureProgress() const { return _featureProgress.load(std::memory_order_relaxed); }
+        std::string const & GetFeatureError() const { return _featureError; }
+
     private:
+        struct FeatureJobResult {
+            std::filesystem::path Path;
+            std::string Error;
+            FeatureTimeline::BuildStats Stats;
+        };
+
+        // The locked part of LoadFile: swap the decoder, reset the ring and restart the device.
+        bool LoadDecoder(std::string const & path);
         static void DataCallback(ma_device * device, void * output, void const * input, ma_uint32 frameCount);
         void HandleCallback(float * output, ma_uint32 frameCount);
         bool StartDevice();
         void StopDevice();
         void ResetRing(std::uint32_t sampleRate);
-        void WriteRing(const float * samples, std::size_t frames);
+        // stereo: interleaved left/right per frame, or nullptr to repeat the mono samples.
+        void WriteRing(const float * samples, const float * stereo, std::size_t frames);
         std::size_t ReadRing(float * dst, std::size_t maxSamples);
         std::size_t RingReadable() const;
         std::size_t RingCapacity() const;
@@ -89,12 +136,25 @@ namespace VCX::Apps::SphereAudioVisualizer {
         float         _sinePhase   = 0.f;
         std::vector<float> _scratch;
         std::vector<float> _ring;
+        std::vector<float> _stereoScratch;
+        std::vector<float> _stereoRing; // interleaved left/right, same frame positions as _ring
         std::size_t    _ringCapacity = 0;
         std::atomic<std::size_t> _ringWrite{0};
         std::atomic<std::size_t> _ringRead{0};
         std::atomic<bool> _monoMixMode{true};
+        std::atomic<bool> _stereoCapture{false};
+        std::atomic<std::uint64_t> _stereoFrom{0}; // first sample of the current stereo capture, max when off
+        bool          _stereoWriting = false;      // capture state the callback last applied
         std::mutex    _mutex; // protects decoder seek/reset during load/stop
 
+        AudioAnalysisSettings _featureSettings;
+        FeatureTimeline _featureTimeline;
+        std::string _featureError;
+        bool _featureJobRunning = false;
+        std::atomic<bool> _featureCancel{false};
+        std::atomic<float> _featureProgress{0.f};
+        VCX::Engine::Async<FeatureJobResult> _featureJob; // declared last: joins before the state it uses is destroyed
+
         static constexpr float kTau = 6.28318530718f;
     };
 }
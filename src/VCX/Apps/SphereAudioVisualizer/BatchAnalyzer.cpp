@@ -0,0 +1,275 @@
+#include "Apps/SphereAudioVisualizer/BatchAnalyzer.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/core.h>
+#include <spdlog/spdlog.h>
+#include <yaml-cpp/yaml.h>
+
+#include "Apps/SphereAudioVisualizer/AudioAnalysis.hpp"
+#include "Apps/SphereAudioVisualizer/FeatureTimeline.hpp"
+#include "Apps/SphereAudioVisualizer/TempoTracker.hpp"
+#include "Engine/Parallel.hpp"
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    namespace {
+        struct AnalyzeOptions {
+            std::vector<std::filesystem::path> Inputs;
+            std::filesystem::path OutputDir  { "analysis" };
+            std::filesystem::path ConfigPath { "SphereVisConfig.yaml" };
+            bool ConfigExplicit = false;
+        };
+
+        struct TrackJob {
+            std::filesystem::path Source;
+            std::filesystem::path Output;
+            bool Ok = false;
+            std::string Error;
+            FeatureTimeline::BuildStats Stats;
+            std::uint32_t SampleRate = 0;
+            float Bpm = 0.f;
+            float BpmConfidence = 0.f;
+            float MeanRmsDb = -96.f;
+            float PeakRmsDb = -96.f;
+        };
+
+        bool IsAudioFile(std::filesystem::path const & path) {
+            auto ext = path.extension().string();
+            std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            return ext == ".wav" || ext == ".flac" || ext == ".mp3" || ext == ".ogg";
+        }
+
+        bool ParseOptions(int const argc, char * argv[], AnalyzeOptions & options) {
+            constexpr std::string_view appPrefix { "--app=" };
+            constexpr std::string_view outPrefix { "--out=" };
+            constexpr std::string_view configPrefix { "--config=" };
+            for (int i = 1; i < argc; ++i) {
+                std::string_view const arg { argv[i] ? argv[i] : "" };
+                if (arg == "--app") {
+                    ++i; // value consumed by main
+                } else if (arg.rfind(appPrefix, 0) == 0) {
+                    continue;
+                } else if (arg.rfind(outPrefix, 0) == 0) {
+                    options.OutputDir = std::string(arg.substr(outPrefix.size()));
+                } else if (arg.rfind(configPrefix, 0) == 0) {
+                    options.ConfigPath     = std::string(arg.substr(configPrefix.size()));
+                    options.ConfigExplicit = true;
+                } else if (arg.rfind("--", 0) == 0) {
+                    spdlog::error("analyze: unknown option '{}'", arg);
+                    return false;
+                } else if (! arg.empty()) {
+                    options.Inputs.emplace_back(std::string(arg));
+                }
+            }
+            return true;
+        }
+
+        bool LoadSettings(AnalyzeOptions const & options, AudioAnalysisSettings & settings) {
+            std::error_code ec;
+            if (! std::filesystem::exists(options.ConfigPath, ec)) {
+                if (options.ConfigExplicit) {
+                    spdlog::error("analyze: config '{}' not found", options.ConfigPath.string());
+                    return false;
+                }
+                spdlog::info("analyze: no {} found, using default analysis settings", options.ConfigPath.string());
+                return true;
+            }
+            try {
+                YAML::Node const root = YAML::LoadFile(options.ConfigPath.string());
+                if (auto const analysisNode = root["analysis"]; analysisNode && analysisNode.IsMap()) {
+                    ReadAnalysisSettings(analysisNode, settings);
+                }
+                spdlog::info("analyze: analysis settings from {}", options.ConfigPath.string());
+            } catch (std::exception const & e) {
+                spdlog::error("analyze: failed to read config '{}': {}", options.ConfigPath.string(), e.what());
+                return false;
+            }
+            return true;
+        }
+
+        void CollectInputs(std::vector<std::filesystem::path> const & inputs, std::vector<std::filesystem::path> & files) {
+            std::error_code ec;
+            for (auto const & input : inputs) {
+                if (std::filesystem::is_directory(input, ec)) {
+                    std::vector<std::filesystem::path> found;
+                    auto const opts = std::filesystem::directory_options::skip_permission_denied;
+                    for (auto it = std::filesystem::recursive_directory_iterator(input, opts, ec);
+                         ! ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec)) {
+                        if (it->is_regular_file(ec) && IsAudioFile(it->path())) {
+                            found.push_back(it->path());
+                        }
+                    }
+                    if (ec) {
+                        spdlog::warn("analyze: stopped scanning '{}': {}", input.string(), ec.message());
+                        ec.clear();
+                    }
+                    std::sort(found.begin(), found.end());
+                    files.insert(files.end(), found.begin(), found.end());
+                } else if (std::filesystem::is_regular_file(input, ec)) {
+                    files.push_back(input);
+                } else {
+                    spdlog::warn("analyze: skipping '{}' (not a file or directory)", input.string());
+                }
+            }
+        }
+
+        // One feature file per track, named after the track; clashing stems get a numeric suffix.
+        void AssignOutputs(std::vector<TrackJob> & jobs, std::filesystem::path const & outputDir) {
+            std::set<std::string> used;
+            for (auto & job : jobs) {
+                auto const stem = job.Source.stem().string();
+                std::string name = stem;
+                for (int n = 2; ! used.insert(name).second; ++n) {
+                    name = stem + "_" + std::to_string(n);
+                }
+                job.Output = outputDir / (name + ".vfxt");
+            }
+        }
+
+        // Whole-track statistics for the summary, read back from the written timeline.
+        void Summarize(TrackJob & job, AudioAnalysisSettings const & settings) {
+            FeatureTimeline timeline;
+            if (! timeline.Open(job.Output)) {
+                job.Ok    = false;
+                job.Error = "cannot open written feature file";
+                return;
+            }
+            std::size_t const frames = timeline.GetNumFrames();
+            job.SampleRate = timeline.GetSampleRate();
+
+            TempoTracker tempo;
+            auto tempoSettings = tempo.GetSettings();
+            tempoSettings.PriorBpm = std::clamp(settings.TempoPriorBpm, tempoSettings.MinBpm, tempoSettings.MaxBpm);
+            tempo.SetSettings(tempoSettings);
+            tempo.Reset(timeline.GetFrameRate());
+            double rmsSum = 0.0;
+            for (std::size_t f = 0; f < frames; ++f) {
+                std::uint8_t const flags = timeline.GetOnsetFlags(f);
+                float const onsetWeight = (flags & 1u) ? 1.f : (flags != 0 ? 0.5f : 0.f);
+                tempo.ProcessHop(timeline.GetOnsetEnvelope(f), onsetWeight);
+                rmsSum += timeline.GetRmsDb(f);
+            }
+            if (frames > 0) {
+                job.MeanRmsDb = static_cast<float>(rmsSum / static_cast<double>(frames));
+                job.PeakRmsDb = timeline.FindPeakRms(0, frames - 1).RmsDb;
+            }
+            job.BpmConfidence = tempo.GetConfidence();
+            job.Bpm           = job.BpmConfidence > 0.f ? tempo.GetBpm() : 0.f;
+        }
+
+        std::string CsvField(std::string const & value) {
+            if (value.find_first_of(",\"\n\r") == std::string::npos) return value;
+            std::string quoted { "\"" };
+            for (char const c : value) {
+                if (c == '"') quoted += '"';
+                quoted += c;
+            }
+            quoted += '"';
+            return quoted;
+        }
+
+        bool WriteSummary(std::filesystem::path const & path, std::vector<TrackJob> const & jobs) {
+            std::ofstream out(path, std::ios::trunc);
+            if (! out) return false;
+            out << "path,feature_file,status,duration_s,sample_rate,frames,onsets,bpm,bpm_confidence,"
+                   "mean_rms_dbfs,peak_rms_dbfs,decode_s,analysis_s,error\n";
+            for (auto const & job : jobs) {
+                out << CsvField(job.Source.string()) << ','
+                    << CsvField(job.Ok ? job.Output.string() : std::string()) << ','
+                    << (job.Ok ? "ok" : "failed") << ','
+                    << fmt::format("{:.3f},{},{},{},{:.1f},{:.2f},{:.2f},{:.2f},{:.3f},{:.3f}",
+                           job.Stats.AudioSeconds, job.SampleRate, job.Stats.Frames, job.Stats.Onsets,
+                           job.Bpm, job.BpmConfidence, job.MeanRmsDb, job.PeakRmsDb,
+                           job.Stats.DecodeSeconds, job.Stats.AnalysisSeconds)
+                    << ',' << CsvField(job.Error) << '\n';
+            }
+            return static_cast<bool>(out);
+        }
+    } // namespace
+
+    int RunAnalyzeApp(int argc, char * argv[]) {
+        using Clock = std::chrono::steady_clock;
+
+        AnalyzeOptions options;
+        if (! ParseOptions(argc, argv, options)) return 1;
+        AudioAnalysisSettings settings;
+        if (! LoadSettings(options, settings)) return 1;
+
+        std::vector<std::filesystem::path> files;
+        CollectInputs(options.Inputs, files);
+        if (files.empty()) {
+            spdlog::error("analyze: no audio files given. Usage: apps --app=analyze [--out=<dir>] [--config=<yaml>] <file-or-dir>...");
+            return 1;
+        }
+
+        std::error_code ec;
+        std::filesystem::create_directories(options.OutputDir, ec);
+        if (ec) {
+            spdlog::error("analyze: cannot create output directory '{}': {}", options.OutputDir.string(), ec.message());
+            return 1;
+        }
+
+        std::vector<TrackJob> jobs(files.size());
+        for (std::size_t i = 0; i < files.size(); ++i) jobs[i].Source = files[i];
+        AssignOutputs(jobs, options.OutputDir);
+
+        // With at least a track per worker, one track per task keeps every core busy and the STFT inside
+        // each runs inline. With fewer tracks that would idle the rest, so the tracks go one at a time and
+        // each spreads its STFT frames over the whole pool instead.
+        std::size_t const workers = VCX::Engine::GetWorkerCount();
+        bool const trackParallel = jobs.size() >= workers;
+        spdlog::info("analyze: {} track(s) on {} worker(s) by {}, fft {} / {} bands -> {}",
+            jobs.size(), workers, trackParallel ? "track" : "frame", CurrentFftSize(settings), settings.NumBands, options.OutputDir.string());
+
+        std::atomic<std::size_t> finished { 0 };
+        auto const analyze = [&](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                auto & job = jobs[i];
+                job.Ok = FeatureTimeline::Build(job.Source, job.Output, settings, nullptr, nullptr, &job.Stats, job.Error);
+                if (job.Ok) Summarize(job, settings);
+                std::size_t const done = finished.fetch_add(1) + 1;
+                if (job.Ok) {
+                    spdlog::info("analyze: [{}/{}] {} ({:.1f} s audio, {} onsets, {:.1f} BPM)",
+                        done, jobs.size(), job.Source.string(), job.Stats.AudioSeconds, job.Stats.Onsets, job.Bpm);
+                } else {
+                    spdlog::error("analyze: [{}/{}] {} failed: {}", done, jobs.size(), job.Source.string(), job.Error);
+                }
+            }
+        };
+        auto const start = Clock::now();
+        if (trackParallel) {
+            VCX::Engine::ParallelFor(jobs.size(), 1, analyze);
+        } else {
+            analyze(0, jobs.size());
+        }
+        double const wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        double audioSeconds = 0.0;
+        std::size_t failed = 0;
+        for (auto const & job : jobs) {
+            if (job.Ok) audioSeconds += job.Stats.AudioSeconds;
+            else ++failed;
+        }
+
+        auto const summaryPath = options.OutputDir / "summary.csv";
+        if (! WriteSummary(summaryPath, jobs)) {
+            spdlog::error("analyze: cannot write {}", summaryPath.string());
+            return 1;
+        }
+
+        spdlog::info("analyze: {} ok, {} failed; {:.1f} s of audio in {:.2f} s wall = {:.1f} audio-s per wall-s. Summary: {}",
+            jobs.size() - failed, failed, audioSeconds, wallSeconds,
+            wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0, summaryPath.string());
+        return failed == 0 ? 0 : 1;
+    }
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -0,0 +1,14 @@
+#pragma once
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    /**
+     * Headless "analyze" app: builds feature timelines for every audio file given on the command line
+     * (directories are scanned recursively), in parallel, and writes a summary CSV next to them.
+     *
+     *   apps --app=analyze [--out=<dir>] [--config=<yaml>] <file-or-dir>...
+     *
+     * The "analysis" section of the config (SphereVisConfig.yaml by default) selects the same
+     * AudioAnalysisSettings the live visualizer uses. Returns non-zero if any track failed.
+     */
+    int RunAnalyzeApp(int argc, char * argv[]);
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -0,0 +1,139 @@
+#include "Apps/SphereAudioVisualizer/ChromaAnalyzer.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    namespace {
+        constexpr float kSilenceFloor = 1e-12f;
+        constexpr float kMinKeySeconds = 2.f; // long-term chroma needed before the first estimate
+
+        using Profile = std::array<float, kPitchClasses>;
+
+        // Krumhansl-Kessler probe-tone ratings, tonic first.
+        constexpr Profile kMajorProfile { 6.35f, 2.23f, 3.48f, 2.33f, 4.38f, 4.09f, 2.52f, 5.19f, 2.39f, 3.66f, 2.29f, 2.88f };
+        constexpr Profile kMinorProfile { 6.33f, 2.68f, 3.52f, 5.38f, 2.60f, 3.53f, 2.54f, 4.75f, 3.98f, 2.69f, 3.34f, 3.17f };
+
+        // Zero mean, unit length, so a dot product with another such vector is the Pearson correlation.
+        Profile Standardize(Profile values) {
+            float mean = 0.f;
+            for (float v : values) mean += v;
+            mean /= static_cast<float>(kPitchClasses);
+            float norm = 0.f;
+            for (float & v : values) {
+                v -= mean;
+                norm += v * v;
+            }
+            norm = std::sqrt(norm);
+            for (float & v : values) v = norm > 0.f ? v / norm : 0.f;
+            return values;
+        }
+
+        // Power per mapped bin, faded by the pitch weight. The arrays never overlap, so the loop vectorises.
+        void WeightBins(float const * __restrict magnitude, float const * __restrict weights, float * __restrict weighted, std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                weighted[i] = weights[i] * magnitude[i] * magnitude[i];
+            }
+        }
+    }
+
+    char const * PitchClassName(int pitchClass) {
+        static constexpr char const * kNames[kPitchClasses] { "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B" };
+        return kNames[((pitchClass % kPitchClasses) + kPitchClasses) % kPitchClasses];
+    }
+
+    void ChromaAnalyzer::Configure(int fftSize, int sampleRate) {
+        if (fftSize == _fftSize && sampleRate == _sampleRate) return;
+        _fftSize = fftSize;
+        _sampleRate = sampleRate;
+        _weights.clear();
+        _runs.clear();
+        _firstBin = 0;
+        if (fftSize > 0 && sampleRate > 0) {
+            float const binHz = static_cast<float>(sampleRate) / static_cast<float>(fftSize);
+            auto const first = std::max<std::size_t>(1, static_cast<std::size_t>(std::ceil(kMinFrequency / binHz)));
+            auto const last = std::min<std::size_t>(static_cast<std::size_t>(fftSize / 2) - 1, static_cast<std::size_t>(kMaxFrequency / binHz));
+            _firstBin = first;
+            for (std::size_t bin = first; bin <= last; ++bin) {
+                float const midi = 69.f + 12.f * std::log2(static_cast<float>(bin) * binHz / 440.f);
+                float const nearest = std::round(midi);
+                float const fade = std::cos(std::numbers::pi_v<float> * (midi - nearest));
+                int const pitchClass = ((static_cast<int>(nearest) % kPitchClasses) + kPitchClasses) % kPitchClasses;
+                _weights.push_back(fade * fade);
+                auto const end = static_cast<std::uint32_t>(_weights.size());
+                if (!_runs.empty() && _runs.back().PitchClass == pitchClass) {
+                    _runs.back().End = end;
+                } else {
+                    _runs.push_back({ end, pitchClass });
+                }
+            }
+        }
+        _weighted.resize(_weights.size());
+        Reset();
+    }
+
+    void ChromaAnalyzer::Reset() {
+        _chroma.fill(0.f);
+        _longTerm.fill(0.f);
+        _longTermSeconds = 0.f;
+        _framesSinceKey = 0;
+        _key = {};
+    }
+
+    bool ChromaAnalyzer::Process(AudioAnalysisSettings const & settings, std::vector<float> const & magnitude, float frameSeconds) {
+        if (_weights.empty() || magnitude.size() != static_cast<std::size_t>(_fftSize / 2)) return false;
+
+        WeightBins(magnitude.data() + _firstBin, _weights.data(), _weighted.data(), _weights.size());
+        std::array<float, kPitchClasses> raw {};
+        std::uint32_t begin = 0;
+        for (auto const & run : _runs) {
+            float sum = 0.f;
+            for (std::uint32_t i = begin; i < run.End; ++i) sum += _weighted[i];
+            raw[static_cast<std::size_t>(run.PitchClass)] += sum;
+            begin = run.End;
+        }
+
+        float const peak = *std::max_element(raw.begin(), raw.end());
+        if (peak <= kSilenceFloor) {
+            // Silence says nothing about harmony: keep the last chroma and key.
+            return false;
+        }
+        for (int i = 0; i < kPitchClasses; ++i) {
+            _chroma[static_cast<std::size_t>(i)] = raw[static_cast<std::size_t>(i)] / peak;
+        }
+
+        float const blend = 1.f - std::exp(-std::max(frameSeconds, 0.f) / std::max(settings.ChromaKeySeconds, 0.1f));
+        for (int i = 0; i < kPitchClasses; ++i) {
+            auto & value = _longTerm[static_cast<std::size_t>(i)];
+            value += blend * (_chroma[static_cast<std::size_t>(i)] - value);
+        }
+        _longTermSeconds += frameSeconds;
+
+        if (++_framesSinceKey < std::max(settings.ChromaKeyInterval, 1) || _longTermSeconds < kMinKeySeconds) return false;
+        _framesSinceKey = 0;
+        EstimateKey();
+        return true;
+    }
+
+    void ChromaAnalyzer::EstimateKey() {
+        static Profile const major = Standardize(kMajorProfile);
+        static Profile const minor = Standardize(kMinorProfile);
+        Profile const chroma = Standardize(_longTerm);
+
+        KeyEstimate best;
+        best.Confidence = -2.f;
+        for (int tonic = 0; tonic < kPitchClasses; ++tonic) {
+            float majorScore = 0.f;
+            float minorScore = 0.f;
+            for (int i = 0; i < kPitchClasses; ++i) {
+                float const value = chroma[static_cast<std::size_t>((tonic + i) % kPitchClasses)];
+                majorScore += value * major[static_cast<std::size_t>(i)];
+                minorScore += value * minor[static_cast<std::size_t>(i)];
+            }
+            if (majorScore > best.Confidence) best = { tonic, false, majorScore, true };
+            if (minorScore > best.Confidence) best = { tonic, true, minorScore, true };
+        }
+        _key = best;
+    }
+} // namespace VCX::Apps::SphereAudioVisualizer
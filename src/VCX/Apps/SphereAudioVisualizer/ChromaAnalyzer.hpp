@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Apps/SphereAudioVisualizer/AudioAnalysis.hpp"
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    inline constexpr int kPitchClasses = 12;
+
+    struct KeyEstimate {
+        int Tonic = 0;           // pitch class, 0 = C
+        bool Minor = false;
+        float Confidence = 0.f;  // correlation with the best key profile, -1..1
+        bool Valid = false;      // false until enough chroma has been seen
+    };
+
+    char const * PitchClassName(int pitchClass);
+
+    /**
+     * 12-bin chroma from the shared magnitude spectrum, and a slow key estimate from it.
+     * The bin to pitch-class map is built once per (fftSize, sampleRate). Since pitch rises with the bin,
+     * it is stored as runs of consecutive bins that share a pitch class, plus one weight per bin that
+     * fades towards the semitone edges. A frame is then one vectorised weighting pass over the mapped
+     * bins and one sum per run. Every ChromaKeyInterval frames the long-term chroma is correlated
+     * with the 24 rotated Krumhansl-Kessler profiles.
+     */
+    class ChromaAnalyzer {
+    public:
+        static constexpr float kMinFrequency = 55.f;   // A1
+        static constexpr float kMaxFrequency = 5000.f;
+
+        // Rebuild the pitch-class map when the transform or sample rate changes; that also clears the state.
+        void Configure(int fftSize, int sampleRate);
+        void Reset();
+        // magnitude: fftSize / 2 bins from DC. Returns true when the key estimate was refreshed.
+        bool Process(AudioAnalysisSettings const & settings, std::vector<float> const & magnitude, float frameSeconds);
+
+        std::array<float, kPitchClasses> const & GetChroma() const { return _chroma; } // max bin = 1
+        KeyEstimate const & GetKey() const { return _key; }
+        std::size_t GetMappedBins() const { return _weights.size(); }
+
+    private:
+        struct Run {
+            std::uint32_t End; // one past the last bin, relative to _firstBin
+            int PitchClass;
+        };
+
+        void EstimateKey();
+
+        int _fftSize = 0;
+        int _sampleRate = 0;
+        std::size_t _firstBin = 0;
+        std::vector<float> _weights;  // per mapped bin
+        std::vector<float> _weighted; // scratch: weight * magnitude^2
+        std::vector<Run> _runs;
+
+        std::array<float, kPitchClasses> _chroma {};
+        std::array<float, kPitchClasses> _longTerm {};
+        float _longTermSeconds = 0.f;
+        int _framesSinceKey = 0;
+        KeyEstimate _key;
+    };
+} // namespace VCX::Apps::SphereAudioVisualizer
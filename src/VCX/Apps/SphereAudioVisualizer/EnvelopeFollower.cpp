@@ -0,0 +1,95 @@
+#include "Apps/SphereAudioVisualizer/EnvelopeFollower.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    namespace {
+        constexpr float kMinTimeConstant = 1e-3f; // seconds
+
+        // One pass over all bands. The arrays never overlap and the selects are 0/1 masks, which is what
+        // the compiler needs to turn the loop into SIMD code.
+        void UpdateBands(
+            float const * __restrict in,
+            float const * __restrict attackCoef,
+            float const * __restrict releaseCoef,
+            float * __restrict value,
+            float * __restrict peak,
+            float * __restrict holdLeft,
+            std::size_t n,
+            float dt,
+            float peakFactor,
+            float hold) {
+            for (std::size_t i = 0; i < n; ++i) {
+                float const x = in[i];
+                float const v = value[i];
+                float const up = x > v ? 1.f : 0.f;
+                float const coef = releaseCoef[i] + up * (attackCoef[i] - releaseCoef[i]);
+                float const next = v + coef * (x - v);
+                value[i] = next;
+
+                // A new peak restarts the hold; once the hold runs out the peak decays towards the envelope.
+                float const p = peak[i];
+                float const left = holdLeft[i] - dt;
+                float const holding = left > 0.f ? 1.f : 0.f;
+                float const held = p * (peakFactor + holding * (1.f - peakFactor));
+                float const rising = next >= p ? 1.f : 0.f;
+                float const decayed = std::max(held, next);
+                peak[i] = decayed + rising * (next - decayed);
+                holdLeft[i] = left + rising * (hold - left);
+            }
+        }
+    }
+
+    void EnvelopeFollower::Configure(AudioAnalysisSettings const & settings, std::size_t numBands) {
+        float const attackLow = std::max(settings.EnvelopeAttackLow, kMinTimeConstant);
+        float const attackHigh = std::max(settings.EnvelopeAttackHigh, kMinTimeConstant);
+        float const releaseLow = std::max(settings.EnvelopeReleaseLow, kMinTimeConstant);
+        float const releaseHigh = std::max(settings.EnvelopeReleaseHigh, kMinTimeConstant);
+        _peakHold = settings.PeakHold;
+        _holdSeconds = std::max(settings.PeakHoldSeconds, 0.f);
+        _peakDecay = std::max(settings.PeakDecaySeconds, kMinTimeConstant);
+        if (_value.size() == numBands && attackLow == _attackLow && attackHigh == _attackHigh
+            && releaseLow == _releaseLow && releaseHigh == _releaseHigh) {
+            return;
+        }
+        _attackLow = attackLow;
+        _attackHigh = attackHigh;
+        _releaseLow = releaseLow;
+        _releaseHigh = releaseHigh;
+
+        // Geometric interpolation, so the time constants spread evenly across the (log-spaced) bands.
+        _invAttack.resize(numBands);
+        _invRelease.resize(numBands);
+        for (std::size_t i = 0; i < numBands; ++i) {
+            float const t = numBands > 1 ? static_cast<float>(i) / static_cast<float>(numBands - 1) : 0.f;
+            _invAttack[i] = 1.f / (attackLow * std::pow(attackHigh / attackLow, t));
+            _invRelease[i] = 1.f / (releaseLow * std::pow(releaseHigh / releaseLow, t));
+        }
+        _attackCoef.resize(numBands);
+        _releaseCoef.resize(numBands);
+        _value.resize(numBands, 0.f);
+        _peak.resize(numBands, 0.f);
+        _holdLeft.resize(numBands, 0.f);
+    }
+
+    void EnvelopeFollower::Reset() {
+        std::fill(_value.begin(), _value.end(), 0.f);
+        std::fill(_peak.begin(), _peak.end(), 0.f);
+        std::fill(_holdLeft.begin(), _holdLeft.end(), 0.f);
+    }
+
+    void EnvelopeFollower::Process(std::vector<float> const & input, float deltaTime) {
+        std::size_t const n = std::min(input.size(), _value.size());
+        float const dt = std::max(deltaTime, 0.f);
+        float const peakFactor = std::exp(-dt / _peakDecay);
+
+        // Per-band coefficients for this frame's deltaTime first, so the band pass is select and multiply-add only.
+        for (std::size_t i = 0; i < n; ++i) {
+            _attackCoef[i] = 1.f - std::exp(-dt * _invAttack[i]);
+            _releaseCoef[i] = 1.f - std::exp(-dt * _invRelease[i]);
+        }
+
+        UpdateBands(input.data(), _attackCoef.data(), _releaseCoef.data(), _value.data(), _peak.data(), _holdLeft.data(), n, dt, peakFactor, _holdSeconds);
+    }
+} // namespace VCX::Apps::SphereAudioVisualizer
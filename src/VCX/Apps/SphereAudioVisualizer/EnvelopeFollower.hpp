@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include "Apps/SphereAudioVisualizer/AudioAnalysis.hpp"
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    /**
+     * The one temporal smoothing stage between the analysis and the volume builders: an attack/release
+     * envelope per band, with time constants in seconds interpolated from the lowest to the highest band,
+     * and an optional peak hold that decays after a short hold. Updates scale with deltaTime, so the
+     * response is the same at 30 or 240 fps. State is one array per field, updated in a single
+     * branch-free pass over the bands that the compiler vectorises.
+     */
+    class EnvelopeFollower {
+    public:
+        // Recompute the per-band time constants when the envelope settings or band count changed.
+        void Configure(AudioAnalysisSettings const & settings, std::size_t numBands);
+        void Reset();
+        void Process(std::vector<float> const & input, float deltaTime);
+
+        // The envelope, or the held peaks when peak hold is on; one value per band.
+        std::vector<float> const & GetOutput() const { return _peakHold ? _peak : _value; }
+
+    private:
+        std::vector<float> _invAttack;  // 1 / attack time constant
+        std::vector<float> _invRelease; // 1 / release time constant
+        std::vector<float> _attackCoef;  // 1 - exp(-dt / attack) for the current frame
+        std::vector<float> _releaseCoef;
+        std::vector<float> _value;
+        std::vector<float> _peak;
+        std::vector<float> _holdLeft;   // seconds until the held peak starts to decay
+
+        // Time constants the per-band _invAttack / _invRelease were interpolated from.
+        float _attackLow = 0.f;
+        float _attackHigh = 0.f;
+        float _releaseLow = 0.f;
+        float _releaseHigh = 0.f;
+        bool _peakHold = false;
+        float _holdSeconds = 0.f;
+        float _peakDecay = 1.f;
+    };
+} // namespace VCX::Apps::SphereAudioVisualizer
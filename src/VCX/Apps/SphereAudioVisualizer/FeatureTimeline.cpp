@@ -0,0 +1,533 @@
+#include "Apps/SphereAudioVisualizer/FeatureTimeline.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include <miniaudio.h>
+
+#include "Apps/SphereAudioVisualizer/MultiResolutionSpectrum.hpp"
+#include "Engine/Parallel.hpp"
+#include "kissfft/kiss_fft.h"
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    struct FeatureTimeline::FileHeader {
+        char          Magic[4];
+        std::uint32_t Version;
+        std::uint32_t SampleRate;
+        std::uint32_t HopSize;
+        std::uint32_t FftSize;
+        std::uint32_t NumBands;
+        std::uint32_t SpectrumBins;
+        std::uint32_t Reserved;
+        std::uint64_t NumFrames;
+        std::uint64_t SettingsHash;
+        float         BandScale;     // band byte 255 maps to this energy
+        float         SpectrumScale; // spectrum byte 255 maps to this magnitude (sqrt companded)
+        std::uint64_t RmsOffset;      // float[NumFrames], window RMS in dBFS
+        std::uint64_t EnvelopeOffset; // float[NumFrames]
+        std::uint64_t OnsetOffset;    // uint8[NumFrames]
+        std::uint64_t BandOffset;     // uint8[NumFrames * NumBands]
+        std::uint64_t SpectrumOffset; // uint8[NumFrames * SpectrumBins]
+    };
+
+    namespace {
+        constexpr char          kMagic[4]          = { 'V', 'F', 'X', 'T' };
+        constexpr std::uint32_t kFormatVersion     = 1;
+        constexpr std::size_t   kDecodeChunkFrames = 1 << 16;
+        constexpr std::size_t   kFramesPerTask     = 256;
+        constexpr float         kSilenceDb         = -96.f;
+        constexpr std::size_t   kHeaderSize        = 96; // sizeof(FileHeader)
+
+        // Whether frames records of frameBytes each, starting at offset, lie past the header and inside a file
+        // of fileSize bytes. Divides instead of multiplying, so header values from a foreign file cannot wrap.
+        bool RegionFits(std::uint64_t offset, std::uint64_t frames, std::uint64_t frameBytes, std::size_t alignment, std::size_t fileSize) {
+            return offset >= kHeaderSize
+                && offset <= fileSize
+                && offset % alignment == 0
+                && frameBytes > 0
+                && frames <= (fileSize - offset) / frameBytes;
+        }
+
+        std::uint64_t Fnv1a(void const * data, std::size_t size, std::uint64_t hash = 1469598103934665603ull) {
+            auto const * bytes = static_cast<std::uint8_t const *>(data);
+            for (std::size_t i = 0; i < size; ++i) {
+                hash ^= bytes[i];
+                hash *= 1099511628211ull;
+            }
+            return hash;
+        }
+
+        template<typename T>
+        std::uint64_t HashValue(T const & value, std::uint64_t hash) {
+            return Fnv1a(&value, sizeof(T), hash);
+        }
+
+        std::uint64_t AlignOffset(std::uint64_t offset) {
+            return (offset + 7) & ~std::uint64_t(7);
+        }
+
+        bool IsCancelled(std::atomic<bool> const * cancel) {
+            return cancel != nullptr && cancel->load(std::memory_order_relaxed);
+        }
+
+        void SetProgress(std::atomic<float> * progress, float value) {
+            if (progress) progress->store(value, std::memory_order_relaxed);
+        }
+
+        // Decode the whole track to mono (channel average, as in the player's mono mix mode).
+        bool DecodeMono(std::filesystem::path const & path, std::vector<float> & mono, std::uint32_t & sampleRate, std::atomic<bool> const * cancel, std::atomic<float> * progress, std::string & error) {
+            ma_decoder decoder {};
+            ma_decoder_config cfg = ma_decoder_config_init(ma_format_f32, 0, 0);
+            ma_result res = ma_decoder_init_file(path.string().c_str(), &cfg, &decoder);
+            if (res != MA_SUCCESS) {
+                error = "Failed to open audio: code " + std::to_string(res);
+                return false;
+            }
+            sampleRate = decoder.outputSampleRate;
+            std::uint32_t const channels = std::max<std::uint32_t>(decoder.outputChannels, 1);
+            ma_uint64 totalFrames = 0;
+            ma_decoder_get_length_in_pcm_frames(&decoder, &totalFrames);
+
+            mono.clear();
+            mono.reserve(static_cast<std::size_t>(totalFrames));
+            std::vector<float> interleaved(kDecodeChunkFrames * channels);
+            for (;;) {
+                if (IsCancelled(cancel)) {
+                    ma_decoder_uninit(&decoder);
+                    error = "cancelled";
+                    return false;
+                }
+                ma_uint64 framesRead = 0;
+                res = ma_decoder_read_pcm_frames(&decoder, interleaved.data(), kDecodeChunkFrames, &framesRead);
+                for (ma_uint64 i = 0; i < framesRead; ++i) {
+                    float accum = 0.f;
+                    for (std::uint32_t c = 0; c < channels; ++c) {
+                        accum += interleaved[static_cast<std::size_t>(i) * channels + c];
+                    }
+                    mono.push_back(accum / static_cast<float>(channels));
+                }
+                if (totalFrames > 0) {
+                    SetProgress(progress, 0.3f * std::min(1.f, static_cast<float>(mono.size()) / static_cast<float>(totalFrames)));
+                }
+                if (res != MA_SUCCESS || framesRead < kDecodeChunkFrames) {
+                    break;
+                }
+            }
+            ma_decoder_uninit(&decoder);
+            if (mono.empty()) {
+                error = "Audio file contains no samples";
+                return false;
+            }
+            return true;
+        }
+
+        // Copy the window of size samples ending at end, zero padding outside the track.
+        void CopyWindow(std::vector<float> const & mono, std::int64_t end, std::size_t size, float * dst) {
+            std::int64_t const begin = end - static_cast<std::int64_t>(size);
+            std::int64_t const total = static_cast<std::int64_t>(mono.size());
+            for (std::size_t i = 0; i < size; ++i) {
+                std::int64_t const idx = begin + static_cast<std::int64_t>(i);
+                dst[i] = (idx >= 0 && idx < total) ? mono[static_cast<std::size_t>(idx)] : 0.f;
+            }
+        }
+    }
+
+    FeatureTimeline::~FeatureTimeline() {
+        Close();
+    }
+
+    std::uint64_t FeatureTimeline::HashSettings(AudioAnalysisSettings const & settings) {
+        std::uint64_t hash = HashValue(kFormatVersion, 1469598103934665603ull);
+        hash = HashValue(CurrentFftSize(settings), hash);
+        hash = HashValue(static_cast<int>(settings.Window), hash);
+        if (settings.Window == WindowType::Kaiser) {
+            hash = HashValue(settings.KaiserBeta, hash); // only here, so caches of the other windows stay valid
+        }
+        hash = HashValue(static_cast<int>(settings.Mapping), hash);
+        hash = HashValue(static_cast<int>(settings.Aggregate), hash);
+        hash = HashValue(std::clamp(settings.NumBands, 1, 256), hash);
+        hash = HashValue(settings.MultiResolution, hash);
+        hash = HashValue(settings.CompressK, hash);
+        hash = HashValue(settings.MinFrequency, hash);
+        hash = HashValue(settings.OnsetSensitivity, hash);
+        hash = HashValue(settings.OnsetMinInterval, hash);
+        return hash;
+    }
+
+    std::filesystem::path FeatureTimeline::CachePathFor(std::filesystem::path const & sourcePath, AudioAnalysisSettings const & settings) {
+        std::error_code ec;
+        auto const absolute = std::filesystem::absolute(sourcePath, ec).generic_string();
+        std::uint64_t hash = Fnv1a(absolute.data(), absolute.size());
+        std::uint64_t const fileSize = std::filesystem::file_size(sourcePath, ec);
+        hash = HashValue(ec ? std::uint64_t(0) : fileSize, hash);
+        auto const writeTime = std::filesystem::last_write_time(sourcePath, ec);
+        hash = HashValue(ec ? std::int64_t(0) : static_cast<std::int64_t>(writeTime.time_since_epoch().count()), hash);
+        hash = HashValue(HashSettings(settings), hash);
+
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.vfxt", static_cast<unsigned long long>(hash));
+        return std::filesystem::current_path() / "cache" / "features" / name;
+    }
+
+    bool FeatureTimeline::Build(
+        std::filesystem::path const & sourcePath,
+        std::filesystem::path const & outputPath,
+        AudioAnalysisSettings const & settings,
+        std::atomic<bool> const *     cancel,
+        std::atomic<float> *          progress,
+        BuildStats *                  stats,
+        std::string &                 error) {
+        using Clock = std::chrono::steady_clock;
+        SetProgress(progress, 0.f);
+
+        auto const decodeStart = Clock::now();
+        std::vector<float> mono;
+        std::uint32_t sampleRate = 0;
+        if (!DecodeMono(sourcePath, mono, sampleRate, cancel, progress, error)) {
+            return false;
+        }
+        auto const analysisStart = Clock::now();
+
+        int const fftSize = CurrentFftSize(settings);
+        std::size_t const window = settings.MultiResolution ? MultiResolutionSpectrum::kMaxSize : static_cast<std::size_t>(fftSize);
+        std::size_t const numBands = static_cast<std::size_t>(std::clamp(settings.NumBands, 1, 256));
+        std::size_t const numFrames = (mono.size() + kHopSize - 1) / kHopSize;
+
+        std::vector<float> const & windowCoeffs = GetWindowCoeffs(fftSize, settings.Window, settings.KaiserBeta);
+        std::vector<BandRange> ranges(numBands);
+        for (std::size_t b = 0; b < numBands; ++b) {
+            ranges[b] = ComputeBandRange(settings, static_cast<int>(b), static_cast<int>(numBands), fftSize, static_cast<int>(sampleRate));
+        }
+
+        std::vector<float> bands(numFrames * numBands, 0.f);
+        std::vector<float> spectrum(numFrames * kSpectrumBins, 0.f);
+        std::vector<float> rmsDb(numFrames, kSilenceDb);
+        std::vector<float> envelope(numFrames, 0.f);
+        std::vector<std::uint8_t> onsetFlags(numFrames, 0);
+        std::uint64_t onsetCount = 0;
+
+        // Onset detection carries state from hop to hop, so it runs sequentially next to the parallel STFT pass.
+        std::thread onsetThread([&]() {
+            OnsetDetector detector;
+            detector.Reset(sampleRate);
+            detector.SetSettings({
+                .Sensitivity = settings.OnsetSensitivity,
+                .MinInterval = settings.OnsetMinInterval,
+            });
+            std::vector<float> frame(OnsetDetector::kFrameSize);
+            std::vector<OnsetDetector::Onset> onsets;
+            for (std::size_t f = 0; f < numFrames; ++f) {
+                if ((f & 1023) == 0 && IsCancelled(cancel)) return;
+                std::uint64_t const end = (f + 1) * kHopSize;
+                if (end < OnsetDetector::kFrameSize) continue;
+                CopyWindow(mono, static_cast<std::int64_t>(end), OnsetDetector::kFrameSize, frame.data());
+                onsets.clear();
+                detector.ProcessFrame(frame.data(), end, onsets);
+                envelope[f] = detector.GetEnvelope();
+                for (auto const & onset : onsets) {
+                    onsetFlags[f] |= static_cast<std::uint8_t>(1u << static_cast<unsigned>(onset.Band));
+                }
+                onsetCount += onsets.size();
+            }
+        });
+
+        std::atomic<std::size_t> framesDone { 0 };
+        VCX::Engine::ParallelFor(numFrames, kFramesPerTask, [&](std::size_t first, std::size_t last) {
+            if (IsCancelled(cancel)) return;
+            kiss_fft_cfg cfg = kiss_fft_alloc(fftSize, 0, nullptr, nullptr);
+            MultiResolutionSpectrum multiRes;
+            multiRes.Configure(settings, sampleRate);
+            std::vector<float> bandValues;
+            std::vector<float> samples(window);
+            std::vector<kiss_fft_cpx> fftIn(window);
+            std::vector<kiss_fft_cpx> fftOut(window);
+            std::vector<float> magnitude(window / 2);
+            std::vector<float> downsample;
+            for (std::size_t f = first; f < last; ++f) {
+                CopyWindow(mono, static_cast<std::int64_t>((f + 1) * kHopSize), window, samples.data());
+                WindowStats const stats = MeasureWindow(samples.data(), window);
+                rmsDb[f] = stats.Rms > 1e-5f ? 20.f * std::log10(stats.Rms) : kSilenceDb;
+
+                if (settings.MultiResolution) {
+                    RemoveMean(samples.data(), window, stats.Mean);
+                    multiRes.Process(samples.data(), MultiResolutionSpectrum::kAllLevels);
+                    multiRes.GetBandEnergies(bandValues);
+                    std::copy(bandValues.begin(), bandValues.end(), bands.begin() + static_cast<std::ptrdiff_t>(f * numBands));
+                    DownsampleSpectrum(multiRes.GetSpectrum(0), downsample, kSpectrumBins);
+                    std::copy(downsample.begin(), downsample.end(), spectrum.begin() + static_cast<std::ptrdiff_t>(f * kSpectrumBins));
+                    continue;
+                }
+                WindowIntoFft(samples.data(), stats.Mean, windowCoeffs, fftIn.data(), window);
+                kiss_fft(cfg, fftIn.data(), fftOut.data());
+                for (std::size_t i = 0; i < magnitude.size(); ++i) {
+                    float const re = fftOut[i].r;
+                    float const im = fftOut[i].i;
+                    magnitude[i] = std::sqrt(re * re + im * im) / static_cast<float>(fftSize);
+                }
+                for (std::size_t b = 0; b < numBands; ++b) {
+                    bands[f * numBands + b] = ApplyCompression(AggregateBand(magnitude, ranges[b], settings.Aggregate), settings.CompressK);
+                }
+                DownsampleSpectrum(magnitude, downsample, kSpectrumBins);
+                std::copy(downsample.begin(), downsample.end(), spectrum.begin() + static_cast<std::ptrdiff_t>(f * kSpectrumBins));
+            }
+            kiss_fft_free(cfg);
+            std::size_t const done = framesDone.fetch_add(last - first) + (last - first);
+            SetProgress(progress, 0.3f + 0.65f * static_cast<float>(done) / static_cast<float>(numFrames));
+        });
+        onsetThread.join();
+        if (IsCancelled(cancel)) {
+            error = "cancelled";
+            return false;
+        }
+
+        FileHeader header {};
+        std::memcpy(header.Magic, kMagic, sizeof(kMagic));
+        header.Version = kFormatVersion;
+        header.SampleRate = sampleRate;
+        header.HopSize = static_cast<std::uint32_t>(kHopSize);
+        header.FftSize = static_cast<std::uint32_t>(window);
+        header.NumBands = static_cast<std::uint32_t>(numBands);
+        header.SpectrumBins = static_cast<std::uint32_t>(kSpectrumBins);
+        header.NumFrames = numFrames;
+        header.SettingsHash = HashSettings(settings);
+        header.BandScale = std::max(1e-6f, *std::max_element(bands.begin(), bands.end()));
+        header.SpectrumScale = std::max(1e-9f, *std::max_element(spectrum.begin(), spectrum.end()));
+        header.RmsOffset = AlignOffset(sizeof(FileHeader));
+        header.EnvelopeOffset = AlignOffset(header.RmsOffset + numFrames * sizeof(float));
+        header.OnsetOffset = AlignOffset(header.EnvelopeOffset + numFrames * sizeof(float));
+        header.BandOffset = AlignOffset(header.OnsetOffset + numFrames);
+        header.SpectrumOffset = AlignOffset(header.BandOffset + numFrames * numBands);
+        std::uint64_t const fileSize = header.SpectrumOffset + numFrames * kSpectrumBins;
+
+        std::vector<std::uint8_t> blob(fileSize, 0);
+        std::memcpy(blob.data(), &header, sizeof(header));
+        std::memcpy(blob.data() + header.RmsOffset, rmsDb.data(), numFrames * sizeof(float));
+        std::memcpy(blob.data() + header.EnvelopeOffset, envelope.data(), numFrames * sizeof(float));
+        std::memcpy(blob.data() + header.OnsetOffset, onsetFlags.data(), numFrames);
+        for (std::size_t i = 0; i < bands.size(); ++i) {
+            float const q = std::clamp(bands[i] / header.BandScale, 0.f, 1.f);
+            blob[header.BandOffset + i] = static_cast<std::uint8_t>(std::lround(q * 255.f));
+        }
+        for (std::size_t i = 0; i < spectrum.size(); ++i) {
+            float const q = std::sqrt(std::clamp(spectrum[i] / header.SpectrumScale, 0.f, 1.f));
+            blob[header.SpectrumOffset + i] = static_cast<std::uint8_t>(std::lround(q * 255.f));
+        }
+
+        // Write next to the target and rename, so a reader never maps a half-written file.
+        std::error_code ec;
+        if (auto const parent = outputPath.parent_path(); !parent.empty()) {
+            std::filesystem::create_directories(parent, ec);
+        }
+        auto tmpPath = outputPath;
+        tmpPath += ".tmp";
+        {
+            std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+            if (!out) {
+                error = "Failed to write " + tmpPath.string();
+                return false;
+            }
+            out.write(reinterpret_cast<char const *>(blob.data()), static_cast<std::streamsize>(blob.size()));
+            if (!out) {
+                error = "Failed to write " + tmpPath.string();
+                return false;
+            }
+        }
+        std::filesystem::rename(tmpPath, outputPath, ec);
+        if (ec) {
+            std::filesystem::remove(tmpPath, ec);
+            error = "Failed to move timeline into " + outputPath.string();
+            return false;
+        }
+
+        auto const buildEnd = Clock::now();
+        if (stats) {
+            stats->AudioSeconds = static_cast<double>(mono.size()) / static_cast<double>(std::max<std::uint32_t>(sampleRate, 1));
+            stats->DecodeSeconds = std::chrono::duration<double>(analysisStart - decodeStart).count();
+            stats->AnalysisSeconds = std::chrono::duration<double>(buildEnd - analysisStart).count();
+            stats->Frames = numFrames;
+            stats->Onsets = onsetCount;
+        }
+        SetProgress(progress, 1.f);
+        return true;
+    }
+
+    bool FeatureTimeline::Open(std::filesystem::path const & path) {
+        Close();
+#ifdef _WIN32
+        HANDLE file = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER size {};
+        if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(FileHeader))) {
+            CloseHandle(file);
+            return false;
+        }
+        HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping == nullptr) {
+            CloseHandle(file);
+            return false;
+        }
+        void * view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        if (view == nullptr) {
+            CloseHandle(mapping);
+            CloseHandle(file);
+            return false;
+        }
+        _fileHandle = file;
+        _mappingHandle = mapping;
+        _data = static_cast<std::uint8_t const *>(view);
+        _size = static_cast<std::size_t>(size.QuadPart);
+#else
+        int const fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st {};
+        if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+            ::close(fd);
+            return false;
+        }
+        void * view = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (view == MAP_FAILED) return false;
+        _data = static_cast<std::uint8_t const *>(view);
+        _size = static_cast<std::size_t>(st.st_size);
+#endif
+
+        auto const * header = Header();
+        std::uint64_t const frames = header->NumFrames;
+        bool valid = std::memcmp(header->Magic, kMagic, sizeof(kMagic)) == 0
+            && header->Version == kFormatVersion
+            && header->HopSize == kHopSize
+            && header->SpectrumBins == kSpectrumBins
+            && header->NumBands > 0 && header->SampleRate > 0 && frames > 0;
+        valid = valid
+            && RegionFits(header->RmsOffset, frames, sizeof(float), alignof(float), _size)
+            && RegionFits(header->EnvelopeOffset, frames, sizeof(float), alignof(float), _size)
+            && RegionFits(header->OnsetOffset, frames, 1, 1, _size)
+            && RegionFits(header->BandOffset, frames, header->NumBands, 1, _size)
+            && RegionFits(header->SpectrumOffset, frames, header->SpectrumBins, 1, _size);
+        if (!valid) {
+            Close();
+            return false;
+        }
+        return true;
+    }
+
+    void FeatureTimeline::Close() {
+        if (_data == nullptr) return;
+#ifdef _WIN32
+        UnmapViewOfFile(_data);
+        CloseHandle(static_cast<HANDLE>(_mappingHandle));
+        CloseHandle(static_cast<HANDLE>(_fileHandle));
+        _mappingHandle = nullptr;
+        _fileHandle = nullptr;
+#else
+        ::munmap(const_cast<std::uint8_t *>(_data), _size);
+#endif
+        _data = nullptr;
+        _size = 0;
+    }
+
+    FeatureTimeline::FileHeader const * FeatureTimeline::Header() const {
+        static_assert(sizeof(FileHeader) == kHeaderSize, "timeline header layout changed");
+        return reinterpret_cast<FileHeader const *>(_data);
+    }
+
+    std::uint64_t FeatureTimeline::GetSettingsHash() const { return IsOpen() ? Header()->SettingsHash : 0; }
+    std::uint32_t FeatureTimeline::GetSampleRate() const { return IsOpen() ? Header()->SampleRate : 0; }
+    std::size_t FeatureTimeline::GetNumFrames() const { return IsOpen() ? static_cast<std::size_t>(Header()->NumFrames) : 0; }
+    std::size_t FeatureTimeline::GetNumBands() const { return IsOpen() ? Header()->NumBands : 0; }
+
+    float FeatureTimeline::GetFrameRate() const {
+        return IsOpen() ? static_cast<float>(Header()->SampleRate) / static_cast<float>(kHopSize) : 0.f;
+    }
+
+    std::size_t FeatureTimeline::FrameAt(float seconds) const {
+        std::size_t const frames = GetNumFrames();
+        if (frames == 0) return 0;
+        // The frame whose window ends at or just before the playback position.
+        float const frame = seconds * GetFrameRate() - 1.f;
+        return frame <= 0.f ? 0 : std::min(frames - 1, static_cast<std::size_t>(frame));
+    }
+
+    void FeatureTimeline::GetBandEnergies(std::size_t frame, std::vector<float> & out) const {
+        std::size_t const numBands = GetNumBands();
+        out.resize(numBands);
+        if (numBands == 0) return;
+        frame = std::min(frame, GetNumFrames() - 1);
+        auto const * header = Header();
+        auto const * src = _data + header->BandOffset + frame * numBands;
+        float const scale = header->BandScale / 255.f;
+        for (std::size_t b = 0; b < numBands; ++b) {
+            out[b] = static_cast<float>(src[b]) * scale;
+        }
+    }
+
+    void FeatureTimeline::GetSpectrum(std::size_t frame, std::vector<float> & out) const {
+        if (!IsOpen()) {
+            out.clear();
+            return;
+        }
+        out.resize(kSpectrumBins);
+        frame = std::min(frame, GetNumFrames() - 1);
+        auto const * header = Header();
+        auto const * src = _data + header->SpectrumOffset + frame * kSpectrumBins;
+        for (std::size_t i = 0; i < kSpectrumBins; ++i) {
+            float const q = static_cast<float>(src[i]) / 255.f;
+            out[i] = q * q * header->SpectrumScale;
+        }
+    }
+
+    float FeatureTimeline::GetRmsDb(std::size_t frame) const {
+        if (!IsOpen()) return kSilenceDb;
+        float value;
+        std::memcpy(&value, _data + Header()->RmsOffset + std::min(frame, GetNumFrames() - 1) * sizeof(float), sizeof(float));
+        return value;
+    }
+
+    float FeatureTimeline::GetOnsetEnvelope(std::size_t frame) const {
+        if (!IsOpen()) return 0.f;
+        float value;
+        std::memcpy(&value, _data + Header()->EnvelopeOffset + std::min(frame, GetNumFrames() - 1) * sizeof(float), sizeof(float));
+        return value;
+    }
+
+    std::uint8_t FeatureTimeline::GetOnsetFlags(std::size_t frame) const {
+        if (!IsOpen()) return 0;
+        return _data[Header()->OnsetOffset + std::min(frame, GetNumFrames() - 1)];
+    }
+
+    FeatureTimeline::RmsPeak FeatureTimeline::FindPeakRms(std::size_t first, std::size_t last) const {
+        RmsPeak peak;
+        std::size_t const frames = GetNumFrames();
+        if (frames == 0) return peak;
+        last = std::min(last, frames - 1);
+        peak.Frame = std::min(first, last);
+        for (std::size_t f = peak.Frame; f <= last; ++f) {
+            float const value = GetRmsDb(f);
+            if (value > peak.RmsDb) {
+                peak.RmsDb = value;
+                peak.Frame = f;
+            }
+        }
+        return peak;
+    }
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "Apps/SphereAudioVisualizer/AudioAnalysis.hpp"
+#include "Apps/SphereAudioVisualizer/OnsetDetector.hpp"
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    /**
+     * Per-hop analysis of a whole track, stored in a compact binary file and memory-mapped for playback.
+     * Frame f holds the features of the analysis window ending at sample (f + 1) * kHopSize, so the
+     * renderer can look features up by playback time (and ahead of it) without running an FFT.
+     */
+    class FeatureTimeline {
+    public:
+        static constexpr std::size_t kHopSize      = OnsetDetector::kHopSize;
+        static constexpr std::size_t kSpectrumBins = 128;
+
+        struct BuildStats {
+            double        AudioSeconds = 0.0;
+            double        DecodeSeconds = 0.0;
+            double        AnalysisSeconds = 0.0;
+            std::uint64_t Frames = 0;
+            std::uint64_t Onsets = 0;
+        };
+
+        struct RmsPeak {
+            float       RmsDb = -96.f; // window RMS, dBFS
+            std::size_t Frame = 0;
+        };
+
+        FeatureTimeline() = default;
+        ~FeatureTimeline();
+        FeatureTimeline(FeatureTimeline const &) = delete;
+        FeatureTimeline & operator=(FeatureTimeline const &) = delete;
+
+        /**
+         * Decode sourcePath, analyse every hop and write the timeline to outputPath.
+         * Runs on the calling thread and fans the STFT frames out to worker threads.
+         * cancel and progress are optional; progress goes from 0 to 1.
+         */
+        static bool Build(
+            std::filesystem::path const & sourcePath,
+            std::filesystem::path const & outputPath,
+            AudioAnalysisSettings const & settings,
+            std::atomic<bool> const *     cancel,
+            std::atomic<float> *          progress,
+            BuildStats *                  stats,
+            std::string &                 error);
+
+        // Hash of the settings that change the stored features; a timeline is only valid for matching settings.
+        static std::uint64_t HashSettings(AudioAnalysisSettings const & settings);
+        // Cache file for a source track, keyed by its path, size, modification time and the settings hash.
+        static std::filesystem::path CachePathFor(std::filesystem::path const & sourcePath, AudioAnalysisSettings const & settings);
+
+        bool Open(std::filesystem::path const & path);
+        void Close();
+        bool IsOpen() const { return _data != nullptr; }
+
+        std::uint64_t GetSettingsHash() const;
+        std::uint32_t GetSampleRate() const;
+        std::size_t   GetNumFrames() const;
+        std::size_t   GetNumBands() const;
+        float         GetFrameRate() const; // frames per second
+        std::size_t   FrameAt(float seconds) const;
+
+        // Compressed band energies before AGC, as produced by the live analysis.
+        void  GetBandEnergies(std::size_t frame, std::vector<float> & out) const;
+        void  GetSpectrum(std::size_t frame, std::vector<float> & out) const;
+        float GetRmsDb(std::size_t frame) const; // unweighted window RMS in dBFS, not the BS.1770 LUFS of LoudnessMeter
+        float GetOnsetEnvelope(std::size_t frame) const;
+        std::uint8_t GetOnsetFlags(std::size_t frame) const; // bit g set when group g had an onset
+        RmsPeak FindPeakRms(std::size_t first, std::size_t last) const; // inclusive range, clamped
+
+    private:
+        struct FileHeader;
+
+        FileHeader const * Header() const;
+
+        std::uint8_t const * _data = nullptr;
+        std::size_t          _size = 0;
+#ifdef _WIN32
+        void * _fileHandle    = nullptr;
+        void * _mappingHandle = nullptr;
+#endif
+    };
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -26,8 +26,10 @@ namespace VCX::Apps::SphereAudioVisualizer {
     }
 
     GpuVolumeBuilder::GpuVolumeBuilder():
-        _computeProgram({ VCX::Engine::GL::SharedShader("assets/shaders/spherevis_build_volume.comp") }) {
+        _computeProgram({ VCX::Engine::GL::SharedShader("assets/shaders/spherevis_build_volume.comp") }),
+        _brickProgram({ VCX::Engine::GL::SharedShader("assets/shaders/spherevis_build_bricks.comp") }) {
         glGenQueries(1, &_timeQuery);
+        glGenBuffers(1, &_scaleBuffer);
     }
 
     GpuVolumeBuilder::~GpuVolumeBuilder() {
@@ -35,6 +37,10 @@ namespace VCX::Apps::SphereAudioVisualizer {
             glDeleteQueries(1, &_timeQuery);
             _timeQuery = 0;
         }
+        if (_scaleBuffer) {
+            glDeleteBuffers(1, &_scaleBuffer);
+            _scaleBuffer = 0;
+        }
     }
 
     void GpuVolumeBuilder::EnsureResources(std::size_t volumeSize) {
@@ -46,6 +52,7 @@ namespace VCX::Apps::SphereAudioVisualizer {
             return;
         }
         _volumeSize = volumeSize;
+        _buckets.Configure(_volumeSize);
         EnsureTextureAllocated(_volumeSize);
     }
 
@@ -57,6 +64,15 @@ namespace VCX::Apps::SphereAudioVisualizer {
         glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
         glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
         glTexImage3D(GL_TEXTURE_3D, 0, GL_R16F, static_cast<GLsizei>(size), static_cast<GLsizei>(size), static_cast<GLsizei>(size), 0, GL_RED, GL_HALF_FLOAT, nullptr);
+
+        auto const useBricks = _brickTexture.Use();
+        auto const grid = static_cast<GLsizei>(SphereVolumeData::BrickGridSize(size));
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexImage3D(GL_TEXTURE_3D, 0, GL_RG16F, grid, grid, grid, 0, GL_RG, GL_HALF_FLOAT, nullptr);
     }
 
     float GpuVolumeBuilder::ComputeBandGain(std::size_t bandIndex, std::size_t bandCount, float tilt) const {
@@ -80,7 +96,7 @@ namespace VCX::Apps::SphereAudioVisualizer {
         _radiusLayout = settings.RadiusLayout;
         _bandBaseRadius.assign(_bandCount, 0.f);
         _bandGains.assign(_bandCount, 0.f);
-        _smoothedEnergies.assign(_bandCount, 0.f);
+        _energies.assign(_bandCount, 0.f);
 
         float logMin = std::log(kMinRadius);
         float logMax = std::log(kMaxRadius);
@@ -97,29 +113,29 @@ namespace VCX::Apps::SphereAudioVisualizer {
         }
     }
 
-    void GpuVolumeBuilder::UpdateSmoothedEnergies(std::vector<float> const & energies, float smoothingFactor) {
-        if (_smoothedEnergies.size() != _bandCount) {
-            _smoothedEnergies.assign(_bandCount, 0.f);
-        }
-        float smoothing = std::clamp(smoothingFactor, kMinSmoothing, kMaxSmoothing);
-        for (std::size_t i = 0; i < _bandCount; ++i) {
-            float current = (i < energies.size()) ? energies[i] : 0.f;
-            if (smoothing >= 1.f) {
-                _smoothedEnergies[i] = current;
-            } else {
-                _smoothedEnergies[i] += smoothing * (current - _smoothedEnergies[i]);
-            }
-        }
+    void GpuVolumeBuilder::CopyBands(std::vector<float> const & src, std::vector<float> & dst) const {
+        dst.assign(_bandCount, 0.f);
+        std::copy_n(src.begin(), std::min(src.size(), _bandCount), dst.begin());
     }
 
-    GpuVolumeBuilder::BuildStats GpuVolumeBuilder::DispatchBuild(std::vector<float> const & energies, SphereVolumeData::Settings const & settings) {
+    GpuVolumeBuilder::BuildStats GpuVolumeBuilder::DispatchBuild(
+        std::vector<float> const & energies,
+        std::vector<float> const & angular,
+        SphereVolumeData::Settings const & settings) {
         BuildStats stats;
         if (_volumeSize == 0) {
             return stats;
         }
         std::size_t desiredBands = std::max<std::size_t>(1, energies.size());
         UpdateBandTables(desiredBands, settings);
-        UpdateSmoothedEnergies(energies, settings.SmoothingFactor);
+        // No smoothing here: App applies the envelope follower before either builder sees the energies.
+        CopyBands(energies, _energies);
+        // The shader finds each voxel's cell itself; only the small cells x bands table crosses the bus.
+        _buckets.ComputeScales(angular, _bandCount, _cellScales);
+        SphereVolumeData::ComputeShellIntervals(settings, _energies, _bandBaseRadius, _bandGains, _cellScales, _bandCount, _shellIntervals);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, _scaleBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(_cellScales.size() * sizeof(float)), _cellScales.data(), GL_STREAM_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
         float const ampScale = std::clamp(settings.AmpScale, 0.f, kMaxAmpScale);
         float const thicknessScale = std::clamp(settings.ThicknessScale, 0.f, 5.f);
@@ -143,6 +159,7 @@ namespace VCX::Apps::SphereAudioVisualizer {
         setUniform("uGlobalGain", globalGain);
         setUniform("uAmpScale", ampScale);
         setUniform("uThicknessScale", thicknessScale);
+        setUniform("uCellResolution", _buckets.GetResolution());
 
         auto const uploadArray = [this](char const * name, std::vector<float> const & data) {
             auto const location = glGetUniformLocation(_computeProgram.Get(), name);
@@ -152,13 +169,29 @@ namespace VCX::Apps::SphereAudioVisualizer {
         };
         uploadArray("uBandBaseRadius", _bandBaseRadius);
         uploadArray("uBandGains", _bandGains);
-        uploadArray("uEnergies", _smoothedEnergies);
+        uploadArray("uEnergies", _energies);
 
         BindVolumeImage(_volumeTexture.Get());
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, _scaleBuffer);
 
         glBeginQuery(GL_TIME_ELAPSED, _timeQuery);
         auto const groups = static_cast<GLuint>((_volumeSize + kGroupSize - 1) / kGroupSize);
         glDispatchCompute(groups, groups, groups);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, 0);
+        glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+
+        // One workgroup per brick reduces the finished volume into the min / max grid.
+        glUseProgram(_brickProgram.Get());
+        auto const volumeSizeLocation = glGetUniformLocation(_brickProgram.Get(), "uVolumeSize");
+        if (volumeSizeLocation >= 0) {
+            glUniform1i(volumeSizeLocation, static_cast<int>(_volumeSize));
+        }
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_3D, _volumeTexture.Get());
+        glBindImageTexture(1, _brickTexture.Get(), 0, GL_TRUE, 0, GL_WRITE_ONLY, GL_RG16F);
+        auto const bricks = static_cast<GLuint>(SphereVolumeData::BrickGridSize(_volumeSize));
+        glDispatchCompute(bricks, bricks, bricks);
+        glBindTexture(GL_TEXTURE_3D, 0);
         glEndQuery(GL_TIME_ELAPSED);
 
         glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
@@ -175,6 +208,10 @@ namespace VCX::Apps::SphereAudioVisualizer {
         return _volumeTexture.Get();
     }
 
+    GLuint GpuVolumeBuilder::GetBrickTexture() const {
+        return _brickTexture.Get();
+    }
+
     float GpuVolumeBuilder::GetLastBuildMs() const {
         return _lastBuildMs;
     }
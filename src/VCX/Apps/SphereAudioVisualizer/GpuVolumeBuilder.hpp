@@ -6,6 +6,7 @@
 #include <glad/glad.h>
 
 #include "Apps/SphereAudioVisualizer/SphereVolumeData.hpp"
+#include "Apps/SphereAudioVisualizer/SphericalHarmonics.hpp"
 #include "Engine/GL/Program.h"
 
 namespace VCX::Apps::SphereAudioVisualizer {
@@ -20,8 +21,13 @@ namespace VCX::Apps::SphereAudioVisualizer {
         ~GpuVolumeBuilder();
 
         void EnsureResources(std::size_t volumeSize);
-        BuildStats DispatchBuild(std::vector<float> const & energies, SphereVolumeData::Settings const & settings);
+        BuildStats DispatchBuild(
+            std::vector<float> const & energies,
+            std::vector<float> const & angular,
+            SphereVolumeData::Settings const & settings);
         GLuint GetVolumeTexture() const;
+        GLuint GetBrickTexture() const; // RG16F min / max per brick, as SphereVolumeData::GetBrickTextureId
+        std::vector<SphereVolumeData::ShellInterval> const & GetShellIntervals() const { return _shellIntervals; }
         float GetLastBuildMs() const;
         std::size_t GetVolumeSize() const { return _volumeSize; }
 
@@ -33,13 +39,11 @@ namespace VCX::Apps::SphereAudioVisualizer {
         static constexpr float kMaxAmpScale = 5.f;
         static constexpr float kMinGlobalGain = 0.1f;
         static constexpr float kMaxGlobalGain = 5.f;
-        static constexpr float kMinSmoothing = 0.f;
-        static constexpr float kMaxSmoothing = 1.f;
         static constexpr float kMinRadius = 0.05f;
         static constexpr float kMaxRadius = 1.f;
 
         void UpdateBandTables(std::size_t bandCount, SphereVolumeData::Settings const & settings);
-        void UpdateSmoothedEnergies(std::vector<float> const & energies, float smoothingFactor);
+        void CopyBands(std::vector<float> const & src, std::vector<float> & dst) const;
         void EnsureTextureAllocated(std::size_t size);
         float ComputeBandGain(std::size_t bandIndex, std::size_t bandCount, float tilt) const;
 
@@ -47,11 +51,17 @@ namespace VCX::Apps::SphereAudioVisualizer {
         SphereVolumeData::RadiusDistribution _radiusLayout = SphereVolumeData::RadiusDistribution::Linear;
         VCX::Engine::GL::UniqueProgram _computeProgram;
         VCX::Engine::GL::UniqueTexture3D _volumeTexture;
+        VCX::Engine::GL::UniqueProgram _brickProgram;
+        VCX::Engine::GL::UniqueTexture3D _brickTexture;
         GLuint _timeQuery = 0;
+        GLuint _scaleBuffer = 0; // cells x bands radius scale, read by the shader at binding 1
+        DirectionBuckets _buckets;
+        std::vector<float> _cellScales;
+        std::vector<SphereVolumeData::ShellInterval> _shellIntervals;
         std::size_t _bandCount = 0;
         std::vector<float> _bandBaseRadius;
         std::vector<float> _bandGains;
-        std::vector<float> _smoothedEnergies;
+        std::vector<float> _energies;
         float _lastBuildMs = 0.f;
     };
 } // namespace VCX::Apps::SphereAudioVisualizer
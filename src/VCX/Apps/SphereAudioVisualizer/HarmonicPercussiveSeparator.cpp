@@ -0,0 +1,184 @@
+#include "Apps/SphereAudioVisualizer/HarmonicPercussiveSeparator.hpp"
+
+#include <algorithm>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    namespace {
+        constexpr float kMaskEpsilon = 1e-20f;
+
+        std::size_t OddKernel(int size) {
+            auto const k = static_cast<std::size_t>(std::clamp(size, 3, 63));
+            return k | 1;
+        }
+
+        // Running median of a window of k (odd) slots as two indexed heaps: heap[0, k / 2 + 1) is a max-heap
+        // of the lower half, heap[k / 2 + 1, k) a min-heap of the upper half, pos[slot] a slot's index in
+        // heap. The median is the top of the lower half.
+        template<bool Upper>
+        bool HeapBefore(float a, float b) { return Upper ? a < b : a > b; }
+
+        void SwapEntries(std::uint8_t * heap, std::uint8_t * pos, std::size_t a, std::size_t b) {
+            std::swap(heap[a], heap[b]);
+            pos[heap[a]] = static_cast<std::uint8_t>(a);
+            pos[heap[b]] = static_cast<std::uint8_t>(b);
+        }
+
+        template<bool Upper>
+        void SiftUp(float const * values, std::uint8_t * heap, std::uint8_t * pos, std::size_t base, std::size_t i) {
+            while (i > 0) {
+                std::size_t const parent = (i - 1) / 2;
+                if (!HeapBefore<Upper>(values[heap[base + i]], values[heap[base + parent]])) return;
+                SwapEntries(heap, pos, base + i, base + parent);
+                i = parent;
+            }
+        }
+
+        template<bool Upper>
+        void SiftDown(float const * values, std::uint8_t * heap, std::uint8_t * pos, std::size_t base, std::size_t n, std::size_t i) {
+            for (;;) {
+                std::size_t best = i;
+                for (std::size_t child = 2 * i + 1; child <= 2 * i + 2 && child < n; ++child) {
+                    if (HeapBefore<Upper>(values[heap[base + child]], values[heap[base + best]])) best = child;
+                }
+                if (best == i) return;
+                SwapEntries(heap, pos, base + i, base + best);
+                i = best;
+            }
+        }
+
+        // Arrange the heaps for arbitrary values: sorted slots, the lower half reversed into a max-heap.
+        void BuildMedianHeaps(float const * values, std::uint8_t * heap, std::uint8_t * pos, std::size_t k) {
+            for (std::size_t i = 0; i < k; ++i) heap[i] = static_cast<std::uint8_t>(i);
+            std::sort(heap, heap + k, [values](std::uint8_t a, std::uint8_t b) { return values[a] < values[b]; });
+            std::reverse(heap, heap + k / 2 + 1);
+            for (std::size_t i = 0; i < k; ++i) pos[heap[i]] = static_cast<std::uint8_t>(i);
+        }
+
+        // Overwrite one slot and restore both heaps: a sift in the slot's own half, then at most one exchange
+        // of the tops. O(log k), no allocation.
+        void ReplaceSlot(float * values, std::uint8_t * heap, std::uint8_t * pos, std::size_t k, std::size_t slot, float value) {
+            std::size_t const lower = k / 2 + 1;
+            values[slot] = value;
+            std::size_t const p = pos[slot];
+            if (p < lower) {
+                SiftUp<false>(values, heap, pos, 0, p);
+                SiftDown<false>(values, heap, pos, 0, lower, pos[slot]);
+            } else {
+                SiftUp<true>(values, heap, pos, lower, p - lower);
+                SiftDown<true>(values, heap, pos, lower, k - lower, pos[slot] - lower);
+            }
+            if (k > lower && values[heap[0]] > values[heap[lower]]) {
+                SwapEntries(heap, pos, 0, lower);
+                SiftDown<false>(values, heap, pos, 0, lower, 0);
+                SiftDown<true>(values, heap, pos, lower, k - lower, 0);
+            }
+        }
+
+        // Wiener (power 2) soft masks. The arrays never overlap, so the loop vectorises.
+        void ApplyMasks(
+            float const * __restrict magnitude,
+            float const * __restrict harmonicEstimate,
+            float const * __restrict percussiveEstimate,
+            float * __restrict harmonic,
+            float * __restrict percussive,
+            std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                float const h2 = harmonicEstimate[i] * harmonicEstimate[i];
+                float const p2 = percussiveEstimate[i] * percussiveEstimate[i];
+                float const mask = h2 / (h2 + p2 + kMaskEpsilon);
+                harmonic[i] = magnitude[i] * mask;
+                percussive[i] = magnitude[i] - harmonic[i];
+            }
+        }
+    }
+
+    void HarmonicPercussiveSeparator::Configure(AudioAnalysisSettings const & settings, std::size_t bins) {
+        std::size_t const timeFrames = OddKernel(settings.HpssTimeFrames);
+        std::size_t const freqBins = OddKernel(settings.HpssFreqBins);
+        if (bins == _bins && timeFrames == _timeFrames && freqBins == _freqBins) return;
+        _bins = bins;
+        _timeFrames = timeFrames;
+        _freqBins = freqBins;
+        _timeRing.resize(_bins * _timeFrames);
+        _timeHeap.resize(_bins * _timeFrames);
+        _timePos.resize(_bins * _timeFrames);
+        _timeMedian.resize(_bins);
+        _freqWindow.resize(_freqBins);
+        _freqHeap.resize(_freqBins);
+        _freqPos.resize(_freqBins);
+        _freqMedian.resize(_bins);
+        _harmonic.resize(_bins);
+        _percussive.resize(_bins);
+        Reset();
+    }
+
+    void HarmonicPercussiveSeparator::Reset() {
+        // All zeros: any arrangement is a valid pair of heaps, so each bin starts in slot order.
+        std::fill(_timeRing.begin(), _timeRing.end(), 0.f);
+        for (std::size_t i = 0; i < _timeHeap.size(); ++i) {
+            _timeHeap[i] = static_cast<std::uint8_t>(i % _timeFrames);
+            _timePos[i] = static_cast<std::uint8_t>(i % _timeFrames);
+        }
+        std::fill(_harmonic.begin(), _harmonic.end(), 0.f);
+        std::fill(_percussive.begin(), _percussive.end(), 0.f);
+        _cursor = 0;
+    }
+
+    void HarmonicPercussiveSeparator::Process(std::vector<float> const & magnitude) {
+        if (magnitude.size() != _bins || _bins == 0) return;
+        float const * x = magnitude.data();
+
+        // Median over time: this frame's value takes the oldest one's ring slot in every bin's window.
+        std::size_t const k = _timeFrames;
+        for (std::size_t bin = 0; bin < _bins; ++bin) {
+            float * ring = _timeRing.data() + bin * k;
+            std::uint8_t * heap = _timeHeap.data() + bin * k;
+            ReplaceSlot(ring, heap, _timePos.data() + bin * k, k, _cursor, x[bin]);
+            _timeMedian[bin] = ring[heap[0]];
+        }
+        _cursor = (_cursor + 1) % k;
+
+        // Median over frequency: heaps built once for the first window (edges repeat the outermost bin), then
+        // slid. Slot j holds bin j - half, so the bin entering at each step reuses the leaving bin's slot.
+        std::size_t const f = _freqBins;
+        auto const half = static_cast<std::ptrdiff_t>(f / 2);
+        auto const last = static_cast<std::ptrdiff_t>(_bins) - 1;
+        auto const at = [&](std::ptrdiff_t i) { return x[std::clamp<std::ptrdiff_t>(i, 0, last)]; };
+        for (std::size_t j = 0; j < f; ++j) {
+            _freqWindow[j] = at(static_cast<std::ptrdiff_t>(j) - half);
+        }
+        BuildMedianHeaps(_freqWindow.data(), _freqHeap.data(), _freqPos.data(), f);
+        for (std::size_t bin = 0; bin < _bins; ++bin) {
+            _freqMedian[bin] = _freqWindow[_freqHeap[0]];
+            auto const i = static_cast<std::ptrdiff_t>(bin);
+            ReplaceSlot(_freqWindow.data(), _freqHeap.data(), _freqPos.data(), f, bin % f, at(i + half + 1));
+        }
+
+        ApplyMasks(x, _timeMedian.data(), _freqMedian.data(), _harmonic.data(), _percussive.data(), _bins);
+    }
+
+    void HarmonicPercussiveSeparator::SplitBands(
+        AudioAnalysisSettings const & settings,
+        int fftSize,
+        int sampleRate,
+        std::vector<float> const & bands,
+        std::vector<float> & harmonic,
+        std::vector<float> & percussive) const {
+        harmonic.resize(bands.size());
+        percussive.resize(bands.size());
+        int const numBands = static_cast<int>(bands.size());
+        for (int b = 0; b < numBands; ++b) {
+            BandRange const range = ComputeBandRange(settings, b, numBands, fftSize, sampleRate);
+            float harmonicSum = 0.f;
+            float total = 0.f;
+            for (int i = std::max(range.Start, 0); i < std::min<int>(range.End, static_cast<int>(_bins)); ++i) {
+                harmonicSum += _harmonic[static_cast<std::size_t>(i)];
+                total += _harmonic[static_cast<std::size_t>(i)] + _percussive[static_cast<std::size_t>(i)];
+            }
+            float const share = total > 0.f ? harmonicSum / total : 0.5f;
+            auto const index = static_cast<std::size_t>(b);
+            harmonic[index] = bands[index] * share;
+            percussive[index] = bands[index] - harmonic[index];
+        }
+    }
+} // namespace VCX::Apps::SphereAudioVisualizer
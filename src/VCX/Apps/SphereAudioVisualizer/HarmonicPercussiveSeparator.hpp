@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Apps/SphereAudioVisualizer/AudioAnalysis.hpp"
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    /**
+     * Real-time harmonic/percussive separation (median-filtering HPSS) of the magnitude spectrum.
+     * Tonal partials are steady over time and percussive hits are flat over frequency, so a median over
+     * the last HpssTimeFrames frames of each bin estimates the harmonic part, a median over HpssFreqBins
+     * neighbouring bins of the current frame the percussive part, and Wiener soft masks split the frame.
+     * The time median is causal (trailing window), so the harmonic part lags onsets by half a window.
+     *
+     * Both medians are running medians over a ring of window slots, kept as two indexed heaps (a
+     * max-heap of the lower half, a min-heap of the upper half). The value entering a window always
+     * takes the slot of the one leaving it, so an update is one O(log k) sift plus at most one exchange
+     * of the heap tops. There is no allocation and no full sort per frame. Kernels are capped at 63,
+     * so slot indices fit in a byte.
+     */
+    class HarmonicPercussiveSeparator {
+    public:
+        static constexpr float kBudgetMs = 0.25f; // per analysis frame at 1024 bins
+
+        // Resize the history when the bin count or kernel sizes change; that also clears it.
+        void Configure(AudioAnalysisSettings const & settings, std::size_t bins);
+        void Reset();
+        void Process(std::vector<float> const & magnitude);
+
+        // Split each band energy by the harmonic share of its spectrum range. The inputs may already be
+        // normalised, because only the ratio is taken from the spectrum.
+        void SplitBands(
+            AudioAnalysisSettings const & settings,
+            int fftSize,
+            int sampleRate,
+            std::vector<float> const & bands,
+            std::vector<float> & harmonic,
+            std::vector<float> & percussive) const;
+
+        std::vector<float> const & GetHarmonicSpectrum() const { return _harmonic; }
+        std::vector<float> const & GetPercussiveSpectrum() const { return _percussive; }
+        std::size_t GetBins() const { return _bins; }
+
+    private:
+        std::size_t _bins = 0;
+        std::size_t _timeFrames = 0; // odd
+        std::size_t _freqBins = 0;   // odd
+        std::size_t _cursor = 0;     // ring slot the next frame overwrites
+
+        std::vector<float> _timeRing;          // [bin][frame] raw magnitudes, ring over frames
+        std::vector<std::uint8_t> _timeHeap;   // [bin][frame] ring slots in heap order
+        std::vector<std::uint8_t> _timePos;    // [bin][frame] heap index of each ring slot
+        std::vector<float> _timeMedian;        // harmonic estimate per bin
+        std::vector<float> _freqWindow;        // sliding window across bins of the current frame, by slot
+        std::vector<std::uint8_t> _freqHeap;
+        std::vector<std::uint8_t> _freqPos;
+        std::vector<float> _freqMedian; // percussive estimate per bin
+        std::vector<float> _harmonic;   // masked spectra
+        std::vector<float> _percussive;
+    };
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -0,0 +1,81 @@
+#include "Apps/SphereAudioVisualizer/LoudnessMeter.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    void LoudnessMeter::Reset(std::uint32_t sampleRate) {
+        _sampleRate = std::max<std::uint32_t>(sampleRate, 1);
+        double const rate = static_cast<double>(_sampleRate);
+        double const pi = 3.14159265358979323846;
+
+        // K-weighting at any sample rate, from the analogue prototypes behind the 48 kHz coefficients in BS.1770.
+        {
+            double const f0 = 1681.974450955533;
+            double const gainDb = 3.999843853973347;
+            double const q = 0.7071752369554196;
+            double const k = std::tan(pi * f0 / rate);
+            double const vh = std::pow(10.0, gainDb / 20.0);
+            double const vb = std::pow(vh, 0.4996667741545416);
+            double const a0 = 1.0 + k / q + k * k;
+            _shelf = {};
+            _shelf.B0 = (vh + vb * k / q + k * k) / a0;
+            _shelf.B1 = 2.0 * (k * k - vh) / a0;
+            _shelf.B2 = (vh - vb * k / q + k * k) / a0;
+            _shelf.A1 = 2.0 * (k * k - 1.0) / a0;
+            _shelf.A2 = (1.0 - k / q + k * k) / a0;
+        }
+        {
+            double const f0 = 38.13547087602444;
+            double const q = 0.5003270373238773;
+            double const k = std::tan(pi * f0 / rate);
+            double const a0 = 1.0 + k / q + k * k;
+            _highPass = {};
+            _highPass.B0 = 1.0;
+            _highPass.B1 = -2.0;
+            _highPass.B2 = 1.0;
+            _highPass.A1 = 2.0 * (k * k - 1.0) / a0;
+            _highPass.A2 = (1.0 - k / q + k * k) / a0;
+        }
+
+        _blockSize = std::max<std::size_t>(1, _sampleRate / 10);
+        _blockFill = 0;
+        _blockSum = 0.0;
+        _blocks.fill(0.0);
+        _blockPos = 0;
+        _blockCount = 0;
+    }
+
+    void LoudnessMeter::Process(float const * samples, std::size_t count) {
+        for (std::size_t i = 0; i < count; ++i) {
+            double const y = _highPass.Process(_shelf.Process(samples[i]));
+            _blockSum += y * y;
+            if (++_blockFill == _blockSize) {
+                _blocks[_blockPos] = _blockSum / static_cast<double>(_blockSize);
+                _blockPos = (_blockPos + 1) % kShortTermBlocks;
+                _blockCount = std::min(_blockCount + 1, kShortTermBlocks);
+                _blockFill = 0;
+                _blockSum = 0.0;
+            }
+        }
+    }
+
+    float LoudnessMeter::GetShortTermRms() const {
+        return static_cast<float>(std::sqrt(MeanOfLastBlocks(kShortTermBlocks)));
+    }
+
+    float LoudnessMeter::ToLufs(double meanSquare) {
+        if (meanSquare <= 0.0) return kSilenceLufs;
+        return std::max(kSilenceLufs, static_cast<float>(-0.691 + 10.0 * std::log10(meanSquare)));
+    }
+
+    double LoudnessMeter::MeanOfLastBlocks(std::size_t count) const {
+        count = std::min(count, _blockCount);
+        if (count == 0) return 0.0;
+        double sum = 0.0;
+        for (std::size_t i = 1; i <= count; ++i) {
+            sum += _blocks[(_blockPos + kShortTermBlocks - i) % kShortTermBlocks];
+        }
+        return sum / static_cast<double>(count);
+    }
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    /**
+     * ITU-R BS.1770 loudness of the mono analysis tap: K-weighting (high-shelf pre-filter + RLB high-pass),
+     * mean square over 100 ms blocks, momentary (400 ms) and short-term (3 s) loudness in LUFS.
+     * About a dozen flops per sample; no gating, as the meter follows the signal rather than integrating it.
+     */
+    class LoudnessMeter {
+    public:
+        static constexpr float kSilenceLufs = -70.f; // BS.1770 absolute gate; reported for silence
+
+        void Reset(std::uint32_t sampleRate);
+        void Process(float const * samples, std::size_t count);
+
+        std::uint32_t GetSampleRate() const { return _sampleRate; }
+        float GetMomentaryLufs() const { return ToLufs(MeanOfLastBlocks(kMomentaryBlocks)); }
+        float GetShortTermLufs() const { return ToLufs(MeanOfLastBlocks(kShortTermBlocks)); }
+        // Short-term loudness as the RMS of the K-weighted signal, for the AGC.
+        float GetShortTermRms() const;
+
+    private:
+        static constexpr std::size_t kMomentaryBlocks = 4;  // 400 ms
+        static constexpr std::size_t kShortTermBlocks = 30; // 3 s
+
+        struct Biquad {
+            double B0 = 1.0, B1 = 0.0, B2 = 0.0, A1 = 0.0, A2 = 0.0;
+            double Z1 = 0.0, Z2 = 0.0;
+
+            double Process(double x) {
+                double const y = B0 * x + Z1;
+                Z1 = B1 * x - A1 * y + Z2;
+                Z2 = B2 * x - A2 * y;
+                return y;
+            }
+        };
+
+        static float ToLufs(double meanSquare);
+        double MeanOfLastBlocks(std::size_t count) const;
+
+        std::uint32_t _sampleRate = 48000;
+        Biquad _shelf;
+        Biquad _highPass;
+        std::size_t _blockSize = 4800;
+        std::size_t _blockFill = 0;
+        double _blockSum = 0.0;
+        std::array<double, kShortTermBlocks> _blocks {}; // mean square of completed blocks, ring
+        std::size_t _blockPos = 0;
+        std::size_t _blockCount = 0;
+    };
+} // namespace VCX::Apps::SphereAudioVisualizer
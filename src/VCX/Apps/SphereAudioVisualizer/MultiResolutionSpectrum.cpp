@@ -0,0 +1,116 @@
+#include "Apps/SphereAudioVisualizer/MultiResolutionSpectrum.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    MultiResolutionSpectrum::MultiResolutionSpectrum() {
+        for (std::size_t l = 0; l < kNumLevels; ++l) {
+            auto & level = _levels[l];
+            std::size_t const size = static_cast<std::size_t>(kSizes[l]);
+            level.Cfg = kiss_fft_alloc(kSizes[l], 0, nullptr, nullptr);
+            level.FftIn.resize(size);
+            level.FftOut.resize(size);
+            level.Magnitude.assign(size / 2, 0.f);
+        }
+    }
+
+    MultiResolutionSpectrum::~MultiResolutionSpectrum() {
+        for (auto & level : _levels) {
+            if (level.Cfg) {
+                kiss_fft_free(level.Cfg);
+                level.Cfg = nullptr;
+            }
+        }
+    }
+
+    void MultiResolutionSpectrum::Configure(AudioAnalysisSettings const & settings, std::uint32_t sampleRate) {
+        _aggregate = settings.Aggregate;
+        _compressK = settings.CompressK;
+        int const numBands = std::clamp(settings.NumBands, 1, 256);
+        sampleRate = std::max<std::uint32_t>(sampleRate, 1);
+        bool const windowChanged = settings.Window != _window || settings.KaiserBeta != _kaiserBeta || _levels[0].WindowCoeffs == nullptr;
+        if (!windowChanged && settings.Mapping == _mapping && numBands == _numBands
+            && settings.MinFrequency == _minFrequency && sampleRate == _sampleRate) {
+            return;
+        }
+        if (windowChanged) {
+            for (std::size_t l = 0; l < kNumLevels; ++l) {
+                _levels[l].WindowCoeffs = &GetWindowCoeffs(kSizes[l], settings.Window, settings.KaiserBeta);
+            }
+        }
+        _window = settings.Window;
+        _kaiserBeta = settings.KaiserBeta;
+        _mapping = settings.Mapping;
+        _numBands = numBands;
+        _minFrequency = settings.MinFrequency;
+        _sampleRate = sampleRate;
+
+        // Band edges come from the long level; the level is picked by the band centre and widened
+        // again when the band is narrower than one bin of the chosen level.
+        int const rate = static_cast<int>(sampleRate);
+        float const binHz = static_cast<float>(sampleRate) / static_cast<float>(kSizes[0]);
+        _bandLevels.resize(static_cast<std::size_t>(numBands));
+        _bandRanges.resize(static_cast<std::size_t>(numBands));
+        for (int b = 0; b < numBands; ++b) {
+            BandRange const edges = ComputeBandRange(settings, b, numBands, kSizes[0], rate);
+            float const lo = static_cast<float>(edges.Start) * binHz;
+            float const hi = static_cast<float>(edges.End) * binHz;
+            float const centre = lo > 0.f ? std::sqrt(lo * hi) : 0.5f * hi;
+            int level = centre < kLowCrossoverHz ? 0 : (centre < kHighCrossoverHz ? 1 : 2);
+            while (level > 0 && hi - lo < static_cast<float>(sampleRate) / static_cast<float>(kSizes[static_cast<std::size_t>(level)])) {
+                --level;
+            }
+            _bandLevels[static_cast<std::size_t>(b)] = level;
+            _bandRanges[static_cast<std::size_t>(b)] = ComputeBandRange(settings, b, numBands, kSizes[static_cast<std::size_t>(level)], rate);
+        }
+        for (auto & level : _levels) {
+            level.HasRun = false;
+        }
+    }
+
+    unsigned MultiResolutionSpectrum::DueLevels(std::uint64_t sampleClock) {
+        unsigned mask = 0;
+        for (std::size_t l = 0; l < kNumLevels; ++l) {
+            auto & level = _levels[l];
+            auto const hop = static_cast<std::uint64_t>(kSizes[l] / 4);
+            if (!level.HasRun || sampleClock < level.LastClock || sampleClock - level.LastClock >= hop) {
+                level.LastClock = sampleClock;
+                mask |= 1u << l;
+            }
+        }
+        return mask;
+    }
+
+    void MultiResolutionSpectrum::Process(float const * samples, unsigned levelMask) {
+        for (std::size_t l = 0; l < kNumLevels; ++l) {
+            if ((levelMask & (1u << l)) == 0) continue;
+            auto & level = _levels[l];
+            std::size_t const size = static_cast<std::size_t>(kSizes[l]);
+            float const * tail = samples + (kMaxSize - size);
+            float const * coeffs = level.WindowCoeffs->data();
+            for (std::size_t i = 0; i < size; ++i) {
+                level.FftIn[i].r = tail[i] * coeffs[i];
+                level.FftIn[i].i = 0.f;
+            }
+            kiss_fft(level.Cfg, level.FftIn.data(), level.FftOut.data());
+            // Normalised by the transform size, so a steady tone reads the same at every level.
+            float const scale = 1.f / static_cast<float>(size);
+            for (std::size_t i = 0; i < level.Magnitude.size(); ++i) {
+                float const re = level.FftOut[i].r;
+                float const im = level.FftOut[i].i;
+                level.Magnitude[i] = std::sqrt(re * re + im * im) * scale;
+            }
+            level.HasRun = true;
+            ++level.Updates;
+        }
+    }
+
+    void MultiResolutionSpectrum::GetBandEnergies(std::vector<float> & out) const {
+        out.resize(_bandLevels.size());
+        for (std::size_t b = 0; b < _bandLevels.size(); ++b) {
+            auto const & spectrum = _levels[static_cast<std::size_t>(_bandLevels[b])].Magnitude;
+            out[b] = ApplyCompression(AggregateBand(spectrum, _bandRanges[b], _aggregate), _compressK);
+        }
+    }
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Apps/SphereAudioVisualizer/AudioAnalysis.hpp"
+#include "kissfft/kiss_fft.h"
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    /**
+     * Band energies from several FFT sizes over one shared input window: long transforms for the bass,
+     * short ones for the highs. Every level windows the newest samples of the same buffer, and each band
+     * reads the level whose resolution suits its frequency. Levels are refreshed on their own hop, so
+     * the long transform runs less often than the short ones.
+     */
+    class MultiResolutionSpectrum {
+    public:
+        static constexpr std::size_t kNumLevels = 3;
+        static constexpr std::array<int, kNumLevels> kSizes { 4096, 1024, 256 }; // long to short
+        static constexpr std::size_t kMaxSize = 4096;
+        static constexpr unsigned    kAllLevels = (1u << kNumLevels) - 1;
+        static constexpr float       kLowCrossoverHz  = 250.f;  // bands centred below use the long level
+        static constexpr float       kHighCrossoverHz = 2500.f; // bands centred above use the short level
+
+        MultiResolutionSpectrum();
+        ~MultiResolutionSpectrum();
+        MultiResolutionSpectrum(MultiResolutionSpectrum const &) = delete;
+        MultiResolutionSpectrum & operator=(MultiResolutionSpectrum const &) = delete;
+
+        // Rebuild windows and the band-to-level map when the settings or sample rate changed; cheap otherwise.
+        void Configure(AudioAnalysisSettings const & settings, std::uint32_t sampleRate);
+
+        /**
+         * Levels whose hop (a quarter of their size) has elapsed since they last ran at sampleClock.
+         * A rewound clock marks every level due.
+         */
+        unsigned DueLevels(std::uint64_t sampleClock);
+
+        /**
+         * Transform the levels in levelMask. samples holds the newest kMaxSize samples, oldest first,
+         * with the DC offset removed; it is not modified. Other levels keep their previous spectrum.
+         */
+        void Process(float const * samples, unsigned levelMask);
+
+        // Compressed band energies, one per band of the configured settings.
+        void GetBandEnergies(std::vector<float> & out) const;
+
+        std::vector<float> const & GetSpectrum(std::size_t level) const { return _levels[level].Magnitude; }
+        int GetBandLevel(std::size_t band) const { return _bandLevels[band]; }
+        std::size_t GetNumBands() const { return _bandLevels.size(); }
+        std::uint64_t GetUpdateCount(std::size_t level) const { return _levels[level].Updates; }
+
+    private:
+        struct Level {
+            kiss_fft_cfg Cfg = nullptr;
+            std::vector<float> const * WindowCoeffs = nullptr; // shared table from GetWindowCoeffs
+            std::vector<kiss_fft_cpx> FftIn;
+            std::vector<kiss_fft_cpx> FftOut;
+            std::vector<float> Magnitude;
+            std::uint64_t LastClock = 0;
+            std::uint64_t Updates = 0;
+            bool HasRun = false;
+        };
+
+        std::array<Level, kNumLevels> _levels;
+        std::vector<int> _bandLevels;
+        std::vector<BandRange> _bandRanges; // bins of the band in its level's spectrum
+        AggregateType _aggregate = AggregateType::Average;
+        float _compressK = 8.f;
+
+        // Settings the window tables and band-to-level assignment were derived from.
+        WindowType _window = WindowType::Hann;
+        float _kaiserBeta = 0.f;
+        MappingType _mapping = MappingType::Log;
+        int _numBands = 0;
+        float _minFrequency = 0.f;
+        std::uint32_t _sampleRate = 0;
+    };
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -0,0 +1,37 @@
+#include "Apps/SphereAudioVisualizer/NoiseTexture.hpp"
+
+#include <cstdint>
+
+#include "Engine/Parallel.hpp"
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    namespace {
+        constexpr std::uint32_t kNoiseSeed = 0x9e3779b9u;
+
+        // Integer avalanche hash (lowbias32); every texel is independent, so slices need no shared state.
+        std::uint32_t HashTexel(std::uint32_t value) {
+            value ^= value >> 16;
+            value *= 0x7feb352du;
+            value ^= value >> 15;
+            value *= 0x846ca68bu;
+            value ^= value >> 16;
+            return value;
+        }
+    }
+
+    VCX::Engine::Texture3D<VCX::Engine::Formats::R8> BuildTileableValueNoise(std::size_t size) {
+        VCX::Engine::Texture3D<VCX::Engine::Formats::R8> noise(size, size, size);
+        VCX::Engine::ParallelFor(size, 4, [&](std::size_t first, std::size_t last) {
+            for (std::size_t z = first; z < last; ++z) {
+                for (std::size_t y = 0; y < size; ++y) {
+                    for (std::size_t x = 0; x < size; ++x) {
+                        auto const index = static_cast<std::uint32_t>((z * size + y) * size + x);
+                        std::uint32_t const hash = HashTexel(index ^ kNoiseSeed);
+                        noise.At(x, y, z) = static_cast<float>(hash >> 8) / static_cast<float>(1u << 24);
+                    }
+                }
+            }
+        });
+        return noise;
+    }
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Engine/Formats.hpp"
+#include "Engine/TextureND.hpp"
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    inline constexpr std::size_t kNoiseTextureSize = 64;
+
+    /**
+     * Value-noise lattice for the Noise perturbation: one uniform random value per texel, periodic in
+     * size along every axis so a repeating sampler tiles it seamlessly. Sampled at a smoothstep-faded
+     * coordinate, the trilinear filter yields the same value noise the shader used to hash per corner.
+     * Slices are filled in parallel.
+     */
+    VCX::Engine::Texture3D<VCX::Engine::Formats::R8> BuildTileableValueNoise(std::size_t size);
+} // namespace VCX::Apps::SphereAudioVisualizer
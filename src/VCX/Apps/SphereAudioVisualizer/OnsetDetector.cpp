@@ -0,0 +1,131 @@
+#include "Apps/SphereAudioVisualizer/OnsetDetector.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    namespace {
+        // Upper edges of the low and mid groups; the high group runs to Nyquist.
+        constexpr float kLowGroupMaxHz = 150.f;
+        constexpr float kMidGroupMaxHz = 2500.f;
+        constexpr std::size_t kMinHistoryForOnset = 4;
+    }
+
+    OnsetDetector::OnsetDetector() {
+        _fftCfg = kiss_fft_alloc(static_cast<int>(kFrameSize), 0, nullptr, nullptr);
+        _window.resize(kFrameSize);
+        float const denom = static_cast<float>(kFrameSize - 1);
+        for (std::size_t i = 0; i < kFrameSize; ++i) {
+            _window[i] = 0.5f * (1.f - std::cos(6.28318530718f * static_cast<float>(i) / denom));
+        }
+        _fftIn.resize(kFrameSize);
+        _fftOut.resize(kFrameSize);
+        _logMagnitude.assign(kFrameSize / 2, 0.f);
+        _prevLogMagnitude.assign(kFrameSize / 2, 0.f);
+        Reset(_sampleRate);
+    }
+
+    OnsetDetector::~OnsetDetector() {
+        if (_fftCfg) {
+            kiss_fft_free(_fftCfg);
+            _fftCfg = nullptr;
+        }
+    }
+
+    void OnsetDetector::Reset(std::uint32_t sampleRate) {
+        _sampleRate = std::max<std::uint32_t>(sampleRate, 1);
+        _hopCount = 0;
+        _historyPos = 0;
+        _historyFill = 0;
+        _envelope = 0.f;
+        std::fill(_prevLogMagnitude.begin(), _prevLogMagnitude.end(), 0.f);
+        for (auto & history : _history) {
+            history.fill(0.f);
+        }
+        _flux.fill(0.f);
+        _threshold.fill(0.f);
+        _lastOnsetSample.fill(0);
+        _hasOnset.fill(false);
+        UpdateGroupBins();
+    }
+
+    void OnsetDetector::UpdateGroupBins() {
+        std::size_t const half = kFrameSize / 2;
+        auto const binOf = [&](float hz) {
+            auto const bin = static_cast<std::size_t>(std::ceil(hz * static_cast<float>(kFrameSize) / static_cast<float>(_sampleRate)));
+            return std::clamp<std::size_t>(bin, 2, half - 1);
+        };
+        _groupBins[0] = 1; // skip DC
+        _groupBins[1] = binOf(kLowGroupMaxHz);
+        _groupBins[2] = std::max(binOf(kMidGroupMaxHz), _groupBins[1] + 1);
+        _groupBins[3] = half;
+    }
+
+    std::size_t OnsetDetector::ProcessFrame(float const * frame, std::uint64_t endSample, std::vector<Onset> & out) {
+        if (frame == nullptr || _fftCfg == nullptr) {
+            return 0;
+        }
+
+        for (std::size_t i = 0; i < kFrameSize; ++i) {
+            _fftIn[i].r = frame[i] * _window[i];
+            _fftIn[i].i = 0.f;
+        }
+        kiss_fft(_fftCfg, _fftIn.data(), _fftOut.data());
+
+        float const norm = 1.f / static_cast<float>(kFrameSize);
+        for (std::size_t k = 0; k < _logMagnitude.size(); ++k) {
+            float const re = _fftOut[k].r;
+            float const im = _fftOut[k].i;
+            _logMagnitude[k] = std::log1p(kLogScale * std::sqrt(re * re + im * im) * norm);
+        }
+
+        bool const hasPrevious = _hopCount > 0;
+        _envelope = 0.f;
+        for (std::size_t g = 0; g < kNumGroups; ++g) {
+            std::size_t const begin = _groupBins[g];
+            std::size_t const end = std::max(_groupBins[g + 1], begin + 1);
+            float sum = 0.f;
+            for (std::size_t k = begin; k < end; ++k) {
+                sum += std::max(0.f, _logMagnitude[k] - _prevLogMagnitude[k]);
+            }
+            _flux[g] = hasPrevious ? sum / static_cast<float>(end - begin) : 0.f;
+            _envelope += _flux[g];
+        }
+        std::swap(_logMagnitude, _prevLogMagnitude);
+
+        std::size_t appended = 0;
+        auto const minIntervalSamples = static_cast<std::uint64_t>(std::max(_settings.MinInterval, 0.f) * static_cast<float>(_sampleRate));
+        std::size_t const lastPos = (_historyPos + kHistorySize - 1) % kHistorySize;
+        for (std::size_t g = 0; g < kNumGroups; ++g) {
+            auto & history = _history[g];
+            std::array<float, kHistorySize> sorted;
+            std::copy_n(history.begin(), _historyFill, sorted.begin());
+            float median = 0.f;
+            if (_historyFill > 0) {
+                auto const mid = sorted.begin() + _historyFill / 2;
+                std::nth_element(sorted.begin(), mid, sorted.begin() + _historyFill);
+                median = *mid;
+            }
+            _threshold[g] = std::max(_settings.Sensitivity, 0.f) * median + kFluxFloor;
+
+            bool const warm = _historyFill >= kMinHistoryForOnset;
+            bool const rising = _historyFill == 0 || _flux[g] > history[lastPos];
+            bool const spaced = !_hasOnset[g] || endSample >= _lastOnsetSample[g] + minIntervalSamples;
+            if (warm && rising && spaced && _flux[g] > _threshold[g]) {
+                out.push_back(Onset {
+                    .Sample   = endSample,
+                    .Band     = static_cast<Group>(g),
+                    .Strength = _flux[g] / _threshold[g],
+                });
+                _lastOnsetSample[g] = endSample;
+                _hasOnset[g] = true;
+                ++appended;
+            }
+            history[_historyPos] = _flux[g];
+        }
+        _historyPos = (_historyPos + 1) % kHistorySize;
+        _historyFill = std::min(_historyFill + 1, kHistorySize);
+        ++_hopCount;
+        return appended;
+    }
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -0,0 +1,89 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "kissfft/kiss_fft.h"
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    /**
+     * Spectral-flux onset detector running on fixed audio hops, so its output does not depend on the frame rate.
+     * Flux is half-wave rectified per band group and compared against a running median of the recent flux.
+     */
+    class OnsetDetector {
+    public:
+        static constexpr std::size_t kFrameSize = 2048;
+        static constexpr std::size_t kHopSize   = 512;
+        static constexpr std::size_t kNumGroups = 3; // low / mid / high
+
+        enum class Group : std::size_t {
+            Low  = 0,
+            Mid  = 1,
+            High = 2,
+        };
+
+        struct Settings {
+            float Sensitivity = 1.5f; // threshold = Sensitivity * median(flux history) + floor
+            float MinInterval = 0.1f; // seconds between two onsets of the same group
+        };
+
+        struct Onset {
+            std::uint64_t Sample   = 0; // end of the analysed hop, in analysis-ring samples
+            Group         Band     = Group::Low;
+            float         Strength = 0.f; // flux / threshold, >= 1
+        };
+
+        OnsetDetector();
+        ~OnsetDetector();
+        OnsetDetector(OnsetDetector const &) = delete;
+        OnsetDetector & operator=(OnsetDetector const &) = delete;
+
+        void Reset(std::uint32_t sampleRate);
+        void SetSettings(Settings const & settings) { _settings = settings; }
+        Settings const & GetSettings() const { return _settings; }
+
+        /**
+         * Analyse one hop. frame holds kFrameSize samples ending at endSample.
+         * Detected onsets are appended to out.
+         * @return number of onsets appended.
+         */
+        std::size_t ProcessFrame(float const * frame, std::uint64_t endSample, std::vector<Onset> & out);
+
+        std::uint32_t GetSampleRate() const { return _sampleRate; }
+        float GetFlux(Group group) const { return _flux[static_cast<std::size_t>(group)]; }
+        float GetThreshold(Group group) const { return _threshold[static_cast<std::size_t>(group)]; }
+        // Sum of rectified group flux of the last hop; the onset envelope consumed by tempo tracking.
+        float GetEnvelope() const { return _envelope; }
+        std::uint64_t GetHopCount() const { return _hopCount; }
+
+    private:
+        static constexpr std::size_t kHistorySize = 24; // ~256 ms at 48 kHz
+        static constexpr float       kFluxFloor   = 0.01f;
+        static constexpr float       kLogScale    = 10.f;
+
+        void UpdateGroupBins();
+
+        Settings _settings;
+        kiss_fft_cfg _fftCfg = nullptr;
+        std::uint32_t _sampleRate = 48000;
+        std::uint64_t _hopCount = 0;
+
+        std::vector<float> _window;
+        std::vector<kiss_fft_cpx> _fftIn;
+        std::vector<kiss_fft_cpx> _fftOut;
+        std::vector<float> _logMagnitude;
+        std::vector<float> _prevLogMagnitude;
+
+        std::array<std::size_t, kNumGroups + 1> _groupBins {};
+        std::array<std::array<float, kHistorySize>, kNumGroups> _history {};
+        std::array<float, kNumGroups> _flux {};
+        std::array<float, kNumGroups> _threshold {};
+        std::array<std::uint64_t, kNumGroups> _lastOnsetSample {};
+        std::array<bool, kNumGroups> _hasOnset {};
+        std::size_t _historyPos = 0;
+        std::size_t _historyFill = 0;
+        float _envelope = 0.f;
+    };
+} // namespace VCX::Apps::SphereAudioVisualizer
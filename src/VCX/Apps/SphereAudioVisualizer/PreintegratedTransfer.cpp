@@ -0,0 +1,51 @@
+#include "Apps/SphereAudioVisualizer/PreintegratedTransfer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    namespace {
+        constexpr float kMaxAlpha = 1.f - 1.f / 512.f; // past RGBA8 resolution; keeps the extinction finite
+        constexpr float kMinExtinction = 1e-6f;        // below this a segment's colour is its plain mean
+    }
+
+    VCX::Engine::Texture2D<VCX::Engine::Formats::RGBA8> BuildPreintegratedTable(std::vector<glm::vec4> const & samples) {
+        std::size_t const n = samples.size();
+        VCX::Engine::Texture2D<VCX::Engine::Formats::RGBA8> table(n, n);
+        if (n == 0) return table;
+
+        // Trapezoid prefix sums of extinction per reference step, extinction-weighted colour and colour.
+        std::vector<float> extinction(n);
+        std::vector<float> extinctionSum(n, 0.f);
+        std::vector<glm::vec3> weightedSum(n, glm::vec3(0.f));
+        std::vector<glm::vec3> colorSum(n, glm::vec3(0.f));
+        for (std::size_t i = 0; i < n; ++i) {
+            extinction[i] = -std::log(1.f - std::clamp(samples[i].a, 0.f, kMaxAlpha));
+            if (i == 0) continue;
+            glm::vec3 const lower = glm::vec3(samples[i - 1]);
+            glm::vec3 const upper = glm::vec3(samples[i]);
+            extinctionSum[i] = extinctionSum[i - 1] + 0.5f * (extinction[i - 1] + extinction[i]);
+            weightedSum[i] = weightedSum[i - 1] + 0.5f * (extinction[i - 1] * lower + extinction[i] * upper);
+            colorSum[i] = colorSum[i - 1] + 0.5f * (lower + upper);
+        }
+
+        for (std::size_t back = 0; back < n; ++back) {
+            for (std::size_t front = 0; front < n; ++front) {
+                if (front == back) {
+                    table.At(front, back) = samples[front];
+                    continue;
+                }
+                std::size_t const lo = std::min(front, back);
+                std::size_t const hi = std::max(front, back);
+                float const span = static_cast<float>(hi - lo);
+                float const integral = extinctionSum[hi] - extinctionSum[lo];
+                glm::vec3 const color = integral > kMinExtinction * span
+                    ? (weightedSum[hi] - weightedSum[lo]) / integral
+                    : (colorSum[hi] - colorSum[lo]) / span;
+                float const alpha = 1.f - std::exp(-integral / span);
+                table.At(front, back) = glm::vec4(glm::clamp(color, glm::vec3(0.f), glm::vec3(1.f)), alpha);
+            }
+        }
+        return table;
+    }
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Engine/Formats.hpp"
+#include "Engine/TextureND.hpp"
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    /**
+     * Pre-integrated transfer function: texel (front, back) holds the colour and opacity of a ray
+     * segment whose density runs linearly from the front sample to the back one, so a transfer
+     * function with narrow features no longer needs steps short enough to land inside them.
+     *
+     * samples is the 1D transfer function at evenly spaced densities, with alpha per reference step
+     * as in the plain LUT. The table keeps that convention: its alpha is for a segment one reference
+     * step long, and the raymarcher corrects it to the real length as before. Extinction and
+     * extinction-weighted colour are integrated with prefix sums, so the N x N table costs O(N^2).
+     * Self-attenuation inside a segment is neglected.
+     */
+    VCX::Engine::Texture2D<VCX::Engine::Formats::RGBA8> BuildPreintegratedTable(std::vector<glm::vec4> const & samples);
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -0,0 +1,80 @@
+#include "Apps/SphereAudioVisualizer/QuantileNormalizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    namespace {
+        constexpr float kMinHistory = 0.5f; // seconds of weight before a band's range is trusted
+
+        float BucketPosition(float value) {
+            float const u = std::sqrt(std::clamp(value, 0.f, QuantileNormalizer::kMaxValue) / QuantileNormalizer::kMaxValue);
+            return u * static_cast<float>(QuantileNormalizer::kBuckets);
+        }
+
+        float BucketValue(float position) {
+            float const u = position / static_cast<float>(QuantileNormalizer::kBuckets);
+            return u * u * QuantileNormalizer::kMaxValue;
+        }
+    }
+
+    void QuantileNormalizer::Configure(AudioAnalysisSettings const & settings, std::size_t numBands) {
+        _quantileLow = std::clamp(settings.QuantileLow, 0.f, 0.49f);
+        _quantileHigh = std::clamp(settings.QuantileHigh, 0.51f, 1.f);
+        _window = std::max(settings.QuantileWindow, 0.1f);
+        if (_histograms.size() != numBands) {
+            _histograms.assign(numBands, Histogram {});
+            _low.assign(numBands, 0.f);
+            _high.assign(numBands, 1.f);
+        }
+    }
+
+    void QuantileNormalizer::Reset() {
+        std::fill(_histograms.begin(), _histograms.end(), Histogram {});
+        std::fill(_low.begin(), _low.end(), 0.f);
+        std::fill(_high.begin(), _high.end(), 1.f);
+    }
+
+    float QuantileNormalizer::Quantile(Histogram const & histogram, float total, float fraction) {
+        float const target = fraction * total;
+        float cumulative = 0.f;
+        for (std::size_t i = 0; i < kBuckets; ++i) {
+            float const next = cumulative + histogram[i];
+            if (next >= target && histogram[i] > 0.f) {
+                float const t = (target - cumulative) / histogram[i];
+                return BucketValue(static_cast<float>(i) + std::clamp(t, 0.f, 1.f));
+            }
+            cumulative = next;
+        }
+        return kMaxValue;
+    }
+
+    void QuantileNormalizer::Process(std::vector<float> & energies, float deltaTime) {
+        std::size_t const n = std::min(energies.size(), _histograms.size());
+        // Weights are per second, so the quantiles cover the same stretch of time at any frame rate.
+        float const dt = std::max(deltaTime, 0.f);
+        float const decay = std::exp(-dt / _window);
+        for (std::size_t b = 0; b < n; ++b) {
+            auto & histogram = _histograms[b];
+            float total = 0.f;
+            for (auto & weight : histogram) {
+                weight *= decay;
+                total += weight;
+            }
+            auto const bucket = std::min(static_cast<std::size_t>(BucketPosition(energies[b])), kBuckets - 1);
+            histogram[bucket] += dt;
+            total += dt;
+
+            float & value = energies[b];
+            if (total < kMinHistory) {
+                // Not enough history yet: pass through on the AGC's scale.
+                value = std::clamp(value, 0.f, 1.f);
+                continue;
+            }
+            _low[b] = Quantile(histogram, total, _quantileLow);
+            _high[b] = Quantile(histogram, total, _quantileHigh);
+            float const span = _high[b] - _low[b];
+            value = span < kMinSpan ? 0.f : std::clamp((value - _low[b]) / span, 0.f, 1.f);
+        }
+    }
+} // namespace VCX::Apps::SphereAudioVisualizer
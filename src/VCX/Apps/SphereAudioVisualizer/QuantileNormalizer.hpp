@@ -0,0 +1,44 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "Apps/SphereAudioVisualizer/AudioAnalysis.hpp"
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    /**
+     * Per-band normalisation to each band's own recent QuantileLow..QuantileHigh range, as an alternative
+     * to the shared AGC gain: a band that is always loud no longer saturates, and a quiet one still spans
+     * [0, 1]. Each band keeps a histogram with a fixed number of buckets whose weights decay with time
+     * constant QuantileWindow seconds. Buckets are uniform in sqrt(energy) so quiet bands keep
+     * resolution. Memory and work per band and frame are constant (kBuckets).
+     */
+    class QuantileNormalizer {
+    public:
+        static constexpr std::size_t kBuckets  = 128;
+        static constexpr float       kMaxValue = 4.f;   // compressed energy at the top bucket; log1p(32 * 1.5)
+        static constexpr float       kMinSpan  = 0.01f; // below this the band is treated as silent rather than stretched
+
+        void Configure(AudioAnalysisSettings const & settings, std::size_t numBands);
+        void Reset();
+        // Record this frame's compressed energies, then map each into [0, 1] by its band's range.
+        void Process(std::vector<float> & energies, float deltaTime);
+
+        float GetLow(std::size_t band) const { return _low[band]; }
+        float GetHigh(std::size_t band) const { return _high[band]; }
+
+    private:
+        using Histogram = std::array<float, kBuckets>;
+
+        // Energy below which a fraction of the histogram's weight lies, interpolated inside the bucket.
+        static float Quantile(Histogram const & histogram, float total, float fraction);
+
+        std::vector<Histogram> _histograms;
+        std::vector<float> _low;
+        std::vector<float> _high;
+        float _quantileLow = 0.05f;
+        float _quantileHigh = 0.95f;
+        float _window = 10.f;
+    };
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -0,0 +1,107 @@
+#include "Apps/SphereAudioVisualizer/SlidingDftSpectrum.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    bool SlidingDftSpectrum::PreferOverFft(int numBands, int fftSize, float updatesPerSecond, std::uint32_t sampleRate, double fftBias) {
+        double const n = static_cast<double>(std::max(fftSize, 2));
+        double const fftCost = 5.0 * n * std::log2(n) * static_cast<double>(std::max(updatesPerSecond, 1.f));
+        double const slidingCost = kFlopsPerBandSample * static_cast<double>(std::max(numBands, 1)) * static_cast<double>(sampleRate);
+        return slidingCost < fftCost * fftBias;
+    }
+
+    bool SlidingDftSpectrum::IsSelected(AudioAnalysisSettings const & settings, float updatesPerSecond, std::uint32_t sampleRate, bool wasSelected) {
+        switch (settings.SlidingDft) {
+        case SlidingDftMode::On:
+            return true;
+        case SlidingDftMode::Auto:
+            return PreferOverFft(std::clamp(settings.NumBands, 1, 256), CurrentFftSize(settings), updatesPerSecond, sampleRate,
+                wasSelected ? 1.0 + kAutoHysteresis : 1.0 - kAutoHysteresis);
+        case SlidingDftMode::Off:
+        default:
+            return false;
+        }
+    }
+
+    void SlidingDftSpectrum::Configure(AudioAnalysisSettings const & settings, std::uint32_t sampleRate) {
+        _compressK = settings.CompressK;
+        int const numBands = std::clamp(settings.NumBands, 1, 256);
+        int const fftSize = CurrentFftSize(settings);
+        sampleRate = std::max<std::uint32_t>(sampleRate, 1);
+        if (settings.Mapping == _mapping && numBands == _numBands && fftSize == _fftSize
+            && settings.MinFrequency == _minFrequency && sampleRate == _sampleRate) {
+            return;
+        }
+        _mapping = settings.Mapping;
+        _numBands = numBands;
+        _fftSize = fftSize;
+        _minFrequency = settings.MinFrequency;
+        _sampleRate = sampleRate;
+
+        // The Hann bin spans about two bins of its DFT, so a band of width W gets a DFT of 2 * rate / W
+        // samples, capped at the FFT size so the bass resolves no coarser than on the FFT path.
+        double const rate = static_cast<double>(sampleRate);
+        double const binHz = rate / static_cast<double>(fftSize);
+        std::size_t const maxWindow = static_cast<std::size_t>(fftSize);
+        _bands.assign(static_cast<std::size_t>(numBands), Band {});
+        for (int b = 0; b < numBands; ++b) {
+            BandRange const edges = ComputeBandRange(settings, b, numBands, fftSize, static_cast<int>(sampleRate));
+            double const lo = static_cast<double>(edges.Start) * binHz;
+            double const hi = static_cast<double>(edges.End) * binHz;
+            double const centre = lo > 0.0 ? std::sqrt(lo * hi) : 0.5 * hi;
+            auto & band = _bands[static_cast<std::size_t>(b)];
+            band.Length = std::clamp(static_cast<std::size_t>(std::lround(2.0 * rate / std::max(hi - lo, 1.0))), kMinWindow, maxWindow);
+            double const length = static_cast<double>(band.Length);
+            double const k = std::clamp(std::round(centre * length / rate), 1.0, length / 2.0 - 1.0);
+            for (int j = 0; j < 3; ++j) {
+                double const phase = 6.283185307179586 * (k + static_cast<double>(j - 1)) / length;
+                band.Twiddle[j] = kDamping * std::complex<double>(std::cos(phase), std::sin(phase));
+            }
+            band.DelayGain = std::pow(kDamping, length);
+        }
+
+        std::size_t historySize = 1;
+        while (historySize < maxWindow + 1) historySize <<= 1;
+        _history.assign(historySize, 0.f);
+        _historyMask = historySize - 1;
+        Reset();
+    }
+
+    void SlidingDftSpectrum::Reset() {
+        std::fill(_history.begin(), _history.end(), 0.f);
+        _historyPos = 0;
+        _processed = 0;
+        for (auto & band : _bands) {
+            for (auto & state : band.State) state = {};
+        }
+    }
+
+    void SlidingDftSpectrum::ProcessBlock(float const * samples, std::size_t count) {
+        if (_history.empty()) return;
+        for (std::size_t i = 0; i < count; ++i) {
+            double const x = samples[i];
+            _history[_historyPos] = samples[i];
+            for (auto & band : _bands) {
+                double const leaving = _history[(_historyPos - band.Length) & _historyMask];
+                double const delta = x - band.DelayGain * leaving;
+                for (int j = 0; j < 3; ++j) {
+                    band.State[j] = band.Twiddle[j] * (band.State[j] + delta);
+                }
+            }
+            _historyPos = (_historyPos + 1) & _historyMask;
+        }
+        _processed += count;
+    }
+
+    void SlidingDftSpectrum::GetBandEnergies(std::vector<float> & out) const {
+        out.resize(_bands.size());
+        for (std::size_t b = 0; b < _bands.size(); ++b) {
+            auto const & band = _bands[b];
+            // Hann window applied in the frequency domain; scaled like the FFT path so a tone reads the same.
+            std::complex<double> const hann = 0.5 * band.State[1] - 0.25 * (band.State[0] + band.State[2]);
+            float const magnitude = static_cast<float>(std::abs(hann) / static_cast<double>(band.Length));
+            out[b] = ApplyCompression(magnitude, _compressK);
+        }
+    }
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Apps/SphereAudioVisualizer/AudioAnalysis.hpp"
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    /**
+     * Band energies from sliding-DFT resonators, updated sample by sample instead of one FFT per frame.
+     * Each band owns three adjacent bins of a DFT whose length matches the band's width, combined into
+     * a Hann-windowed bin centred on the band; work is O(bands) per sample and the energies always
+     * include the newest sample, so short (treble) bands react within a few hundred samples.
+     *
+     * Crossover: a resonator costs about kFlopsPerBandSample per band and sample, one FFT about
+     * 5 N log2 N per update. With N = 2048 at 60 updates/s and 48 kHz the sliding path is cheaper
+     * up to about 5 bands; PreferOverFft applies the same estimate for SlidingDftMode::Auto, which only
+     * leaves the current path once the other one is kAutoHysteresis cheaper, so fps jitter near the
+     * crossover does not flip it (each switch to the sliding path restarts the resonators).
+     */
+    class SlidingDftSpectrum {
+    public:
+        static constexpr std::size_t kMinWindow          = 64;
+        static constexpr double      kDamping            = 0.999999; // keeps rounding errors from piling up
+        static constexpr double      kFlopsPerBandSample = 24.0;     // three complex multiply-adds
+        static constexpr double      kAutoHysteresis     = 0.25;     // relative cost margin before Auto switches
+
+        // Whether the sliding path costs less than an fftSize FFT repeated updatesPerSecond times, scaled by fftBias.
+        static bool PreferOverFft(int numBands, int fftSize, float updatesPerSecond, std::uint32_t sampleRate, double fftBias = 1.0);
+        // Use the sliding path for this frame, resolving SlidingDftMode::Auto with PreferOverFft biased towards
+        // the path in use (wasSelected) by kAutoHysteresis.
+        static bool IsSelected(AudioAnalysisSettings const & settings, float updatesPerSecond, std::uint32_t sampleRate, bool wasSelected);
+
+        // Rebuild the resonators when the settings or sample rate changed; clears their state.
+        void Configure(AudioAnalysisSettings const & settings, std::uint32_t sampleRate);
+        void Reset();
+        void ProcessBlock(float const * samples, std::size_t count);
+
+        // Compressed band energies, one per band of the configured settings.
+        void GetBandEnergies(std::vector<float> & out) const;
+        std::size_t GetNumBands() const { return _bands.size(); }
+        std::size_t GetWindowLength(std::size_t band) const { return _bands[band].Length; }
+        std::uint64_t GetProcessedSamples() const { return _processed; }
+
+    private:
+        struct Band {
+            std::size_t Length = kMinWindow;    // DFT length in samples
+            double      DelayGain = 1.0;        // kDamping^Length, applied to the sample leaving the window
+            std::complex<double> Twiddle[3];    // bins k-1, k, k+1
+            std::complex<double> State[3];
+        };
+
+        std::vector<Band> _bands;
+        std::vector<float> _history; // power-of-two ring of past samples
+        std::size_t _historyMask = 0;
+        std::size_t _historyPos = 0;
+        std::uint64_t _processed = 0;
+        float _compressK = 8.f;
+
+        // Band layout the resonators were built for; a change rebuilds them and clears their state.
+        MappingType _mapping = MappingType::Log;
+        int _numBands = 0;
+        int _fftSize = 0;
+        float _minFrequency = 0.f;
+        std::uint32_t _sampleRate = 0;
+    };
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -0,0 +1,198 @@
+#include "Apps/SphereAudioVisualizer/SpectralDescriptors.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    namespace {
+        constexpr float kMagnitudeFloor = 1e-12f; // keeps log2 finite for empty bins
+
+        // log2 from the float's exponent and a quadratic in its mantissa; about 0.01 off at worst, plenty
+        // for a geometric mean, and unlike std::log it vectorises.
+        inline float FastLog2(float x) {
+            auto const bits = std::bit_cast<std::uint32_t>(x);
+            auto const exponent = static_cast<float>(static_cast<std::int32_t>((bits >> 23) & 255) - 128);
+            float const mantissa = std::bit_cast<float>((bits & 0x007FFFFFu) | 0x3F800000u); // [1, 2)
+            return exponent + (-0.34484843f * mantissa + 2.02466578f) * mantissa - 0.67487759f;
+        }
+
+        template<std::size_t N>
+        float SumLanes(std::array<float, N> const & lanes) {
+            float sum = 0.f;
+            for (float v : lanes) sum += v;
+            return sum;
+        }
+
+        constexpr std::size_t kLanes = SpectralDescriptorKernel::kLanes;
+
+        struct Lanes {
+            std::array<float, kLanes> Sum {};
+            std::array<float, kLanes> Weighted {};
+            std::array<float, kLanes> LogSum {};
+            std::array<float, kLanes> Peak {};
+            std::array<float, kLanes> Rise {};
+        };
+
+        // The fused pass: lane j accumulates bins j, j + kLanes, ... for every descriptor at once, and the
+        // previous spectrum is replaced as it is read. The arrays never overlap.
+        void AccumulateSpectrum(
+            float const * __restrict magnitude,
+            float * __restrict previous,
+            float * __restrict blockSums,
+            std::size_t blocks,
+            Lanes & lanes) {
+            auto sum = lanes.Sum;
+            auto weighted = lanes.Weighted;
+            auto logSum = lanes.LogSum;
+            auto peak = lanes.Peak;
+            auto rise = lanes.Rise;
+            std::array<float, kLanes> bin;
+            for (std::size_t j = 0; j < kLanes; ++j) bin[j] = static_cast<float>(j);
+            for (std::size_t b = 0; b < blocks; ++b) {
+                std::size_t const base = b * kLanes;
+                std::array<float, kLanes> block;
+                for (std::size_t j = 0; j < kLanes; ++j) {
+                    float const m = magnitude[base + j];
+                    float const d = m - previous[base + j];
+                    sum[j] += m;
+                    weighted[j] += bin[j] * m;
+                    bin[j] += static_cast<float>(kLanes);
+                    logSum[j] += FastLog2(m + kMagnitudeFloor);
+                    peak[j] = m > peak[j] ? m : peak[j];
+                    rise[j] += d > 0.f ? d : 0.f;
+                    previous[base + j] = m;
+                    block[j] = m;
+                }
+                blockSums[b] = SumLanes(block);
+            }
+            lanes = { sum, weighted, logSum, peak, rise };
+        }
+    }
+
+    float GetModulationValue(SpectralDescriptors const & descriptors, ModulationSource source) {
+        switch (source) {
+        case ModulationSource::Centroid:
+            return descriptors.Centroid;
+        case ModulationSource::Rolloff:
+            return descriptors.Rolloff;
+        case ModulationSource::Flatness:
+            return descriptors.Flatness;
+        case ModulationSource::Flux:
+            return descriptors.Flux;
+        case ModulationSource::Crest:
+            return descriptors.Crest;
+        case ModulationSource::ZeroCrossing:
+            return descriptors.ZeroCrossing;
+        case ModulationSource::None:
+        default:
+            return 0.f;
+        }
+    }
+
+    char const * ModulationSourceName(ModulationSource source) {
+        switch (source) {
+        case ModulationSource::Centroid:
+            return "Centroid";
+        case ModulationSource::Rolloff:
+            return "Rolloff";
+        case ModulationSource::Flatness:
+            return "Flatness";
+        case ModulationSource::Flux:
+            return "Flux";
+        case ModulationSource::Crest:
+            return "Crest";
+        case ModulationSource::ZeroCrossing:
+            return "ZeroCrossing";
+        case ModulationSource::None:
+        default:
+            return "None";
+        }
+    }
+
+    bool TryParseModulationSource(std::string const & value, ModulationSource & out) {
+        for (int i = 0; i < kModulationSourceCount; ++i) {
+            auto const source = static_cast<ModulationSource>(i);
+            if (value == ModulationSourceName(source)) {
+                out = source;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void SpectralDescriptorKernel::Reset() {
+        _descriptors = {};
+        _previous.clear();
+    }
+
+    void SpectralDescriptorKernel::Process(std::vector<float> const & magnitude, std::vector<float> const & window) {
+        ProcessWindow(window);
+        std::size_t const bins = magnitude.size();
+        if (bins < kLanes) return;
+        bool const hasPrevious = _previous.size() == bins;
+        if (!hasPrevious) {
+            _previous.assign(bins, 0.f);
+        }
+        std::size_t const blocks = bins / kLanes;
+        _blockSums.resize(blocks);
+
+        Lanes lanes;
+        AccumulateSpectrum(magnitude.data(), _previous.data(), _blockSums.data(), blocks, lanes);
+        // The last bins % kLanes bins are left out of every descriptor.
+        std::size_t const used = blocks * kLanes;
+
+        float const total = SumLanes(lanes.Sum);
+        float const mean = total / static_cast<float>(used);
+        float const nyquistBin = static_cast<float>(bins);
+        auto & d = _descriptors;
+        if (total <= kMagnitudeFloor * static_cast<float>(used)) {
+            d.Centroid = 0.f;
+            d.Rolloff = 0.f;
+            d.Flatness = 0.f;
+            d.Flux = 0.f;
+            d.Crest = 0.f;
+            return;
+        }
+        d.Centroid = std::clamp(SumLanes(lanes.Weighted) / total / nyquistBin, 0.f, 1.f);
+        float const geometricMean = std::exp2(SumLanes(lanes.LogSum) / static_cast<float>(used));
+        d.Flatness = std::clamp(geometricMean / mean, 0.f, 1.f);
+        d.Flux = hasPrevious ? std::clamp(SumLanes(lanes.Rise) / total, 0.f, 1.f) : 0.f;
+        float const peakValue = *std::max_element(lanes.Peak.begin(), lanes.Peak.end());
+        d.Crest = std::clamp(std::log(peakValue / mean) / std::log(static_cast<float>(used)), 0.f, 1.f);
+
+        float const target = kRolloffFraction * total;
+        float cumulative = 0.f;
+        d.Rolloff = 1.f;
+        for (std::size_t b = 0; b < blocks; ++b) {
+            if (cumulative + _blockSums[b] >= target) {
+                float const t = _blockSums[b] > 0.f ? (target - cumulative) / _blockSums[b] : 0.f;
+                d.Rolloff = std::clamp((static_cast<float>(b) + t) * static_cast<float>(kLanes) / nyquistBin, 0.f, 1.f);
+                break;
+            }
+            cumulative += _blockSums[b];
+        }
+    }
+
+    void SpectralDescriptorKernel::ProcessWindow(std::vector<float> const & window) {
+        std::size_t const n = window.size();
+        if (n < 2) return;
+        std::array<float, kLanes> crossings {};
+        float const * x = window.data();
+        std::size_t const pairs = n - 1;
+        std::size_t const blocks = pairs / kLanes;
+        for (std::size_t b = 0; b < blocks; ++b) {
+            std::size_t const base = b * kLanes;
+            for (std::size_t j = 0; j < kLanes; ++j) {
+                crossings[j] += x[base + j] * x[base + j + 1] < 0.f ? 1.f : 0.f;
+            }
+        }
+        float count = SumLanes(crossings);
+        for (std::size_t i = blocks * kLanes; i < pairs; ++i) {
+            count += x[i] * x[i + 1] < 0.f ? 1.f : 0.f;
+        }
+        _descriptors.ZeroCrossing = count / static_cast<float>(pairs);
+    }
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    // All in [0, 1] so any of them can drive a shader parameter directly.
+    struct SpectralDescriptors {
+        float Centroid = 0.f;     // magnitude-weighted mean frequency, fraction of Nyquist
+        float Rolloff = 0.f;      // frequency below which kRolloffFraction of the magnitude lies, fraction of Nyquist
+        float Flatness = 0.f;     // geometric / arithmetic mean: 0 tonal, 1 noise-like
+        float Flux = 0.f;         // rectified rise since the previous spectrum, relative to its total
+        float Crest = 0.f;        // log(peak / mean) / log(bins): 0 flat, 1 a single bin
+        float ZeroCrossing = 0.f; // sign changes per sample of the time window
+    };
+
+    enum class ModulationSource : int { None, Centroid, Rolloff, Flatness, Flux, Crest, ZeroCrossing };
+    inline constexpr int kModulationSourceCount = 7;
+
+    float GetModulationValue(SpectralDescriptors const & descriptors, ModulationSource source);
+    char const * ModulationSourceName(ModulationSource source);
+    bool TryParseModulationSource(std::string const & value, ModulationSource & out);
+
+    /**
+     * All spectral descriptors from one pass over the magnitude spectrum, plus one pass over the time window
+     * for the zero-crossing rate. The spectrum loop keeps kLanes independent partial sums per quantity,
+     * so the compiler can vectorise it without reassociating floating point (no -ffast-math), and uses a
+     * bit-level log2 for the flatness. Rolloff is found afterwards from per-block sums, a scan over
+     * bins / kLanes values.
+     */
+    class SpectralDescriptorKernel {
+    public:
+        static constexpr std::size_t kLanes = 8;
+        static constexpr float kRolloffFraction = 0.85f;
+
+        void Reset();
+        // magnitude: bins from DC towards Nyquist; window: time samples, may be empty.
+        void Process(std::vector<float> const & magnitude, std::vector<float> const & window);
+        // Only the zero-crossing rate, for paths without a spectrum; the spectral values are kept.
+        void ProcessWindow(std::vector<float> const & window);
+
+        SpectralDescriptors const & GetDescriptors() const { return _descriptors; }
+
+    private:
+        SpectralDescriptors _descriptors;
+        std::vector<float> _previous;  // last magnitude spectrum, for the flux
+        std::vector<float> _blockSums; // magnitude per block of kLanes bins, for the rolloff
+    };
+} // namespace VCX::Apps::SphereAudioVisualizer
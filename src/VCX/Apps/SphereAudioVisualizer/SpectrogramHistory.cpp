@@ -0,0 +1,42 @@
+#include "Apps/SphereAudioVisualizer/SpectrogramHistory.hpp"
+
+#include <algorithm>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    void SpectrogramHistory::Resize(std::size_t bins, std::size_t rows) {
+        bins = std::max<std::size_t>(bins, 1);
+        rows = std::max<std::size_t>(rows, 1);
+        if (bins == _bins && rows == _rows) return;
+        _bins = bins;
+        _rows = rows;
+        _data.assign(_bins * _rows, 0.f);
+        _head = 0;
+        _pushCount = 0;
+    }
+
+    void SpectrogramHistory::Clear() {
+        std::fill(_data.begin(), _data.end(), 0.f);
+        _head = 0;
+        _pushCount = 0;
+    }
+
+    void SpectrogramHistory::Push(std::vector<float> const & row) {
+        if (_rows == 0) return;
+        float * dst = _data.data() + _head * _bins;
+        std::size_t const count = std::min(row.size(), _bins);
+        std::copy_n(row.begin(), count, dst);
+        std::fill(dst + count, dst + _bins, 0.f);
+        _head = (_head + 1) % _rows;
+        ++_pushCount;
+    }
+
+    float SpectrogramHistory::GetWrapOffset() const {
+        return _rows == 0 ? 0.f : static_cast<float>(_head) / static_cast<float>(_rows);
+    }
+
+    float const * SpectrogramHistory::GetRow(std::size_t age) const {
+        if (_rows == 0) return nullptr;
+        age = std::min(age, _rows - 1);
+        return GetRingRow((_head + _rows - 1 - age) % _rows);
+    }
+} // namespace VCX::Apps::SphereAudioVisualizer
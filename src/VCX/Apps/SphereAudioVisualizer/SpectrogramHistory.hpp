@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    /**
+     * Scrolling spectrogram kept as a ring of rows (bins x rows, row-major), one row per analysis frame.
+     * Push overwrites the oldest row in place and advances the head, so nothing is shifted; readers
+     * apply GetWrapOffset instead. SpectrogramTexture mirrors the same layout on the GPU; this class
+     * has no GL dependency and also works headless.
+     */
+    class SpectrogramHistory {
+    public:
+        // Reallocates and clears only when the shape changes.
+        void Resize(std::size_t bins, std::size_t rows);
+        void Clear();
+        // Write one row; values beyond row.size() are zero, extra values are dropped.
+        void Push(std::vector<float> const & row);
+
+        std::size_t GetBins() const { return _bins; }
+        std::size_t GetRows() const { return _rows; }
+        // Ring index of the row the next Push writes, which is also the oldest row.
+        std::size_t GetHead() const { return _head; }
+        std::uint64_t GetPushCount() const { return _pushCount; }
+        // GetHead() / GetRows(): texture v of the oldest row, so v = fract(offset + age) walks oldest to newest.
+        float GetWrapOffset() const;
+
+        // age 0 is the newest row.
+        float const * GetRow(std::size_t age) const;
+        float const * GetRingRow(std::size_t index) const { return _data.data() + index * _bins; }
+        std::vector<float> const & GetData() const { return _data; }
+
+    private:
+        std::vector<float> _data;
+        std::size_t _bins = 0;
+        std::size_t _rows = 0;
+        std::size_t _head = 0;
+        std::uint64_t _pushCount = 0;
+    };
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -0,0 +1,45 @@
+#include "Apps/SphereAudioVisualizer/SpectrogramTexture.hpp"
+
+#include <algorithm>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    void SpectrogramTexture::Allocate(SpectrogramHistory const & history) {
+        _bins = history.GetBins();
+        _rows = history.GetRows();
+        auto const useTex = _texture.Use();
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        // Show the single channel as grey in ImGui and debug views.
+        GLint const swizzle[4] = { GL_RED, GL_RED, GL_RED, GL_ONE };
+        glTexParameteriv(GL_TEXTURE_2D, GL_TEXTURE_SWIZZLE_RGBA, swizzle);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_R16F, static_cast<GLsizei>(_bins), static_cast<GLsizei>(_rows), 0, GL_RED, GL_FLOAT, history.GetData().data());
+        _syncedPushes = history.GetPushCount();
+        _lastUploadRows = _rows;
+    }
+
+    void SpectrogramTexture::Sync(SpectrogramHistory const & history) {
+        if (history.GetRows() == 0) return;
+        if (history.GetBins() != _bins || history.GetRows() != _rows || history.GetPushCount() < _syncedPushes) {
+            Allocate(history);
+            return;
+        }
+        std::uint64_t const pending = history.GetPushCount() - _syncedPushes;
+        _lastUploadRows = 0;
+        if (pending == 0) return;
+        if (pending >= _rows) {
+            Allocate(history);
+            return;
+        }
+
+        auto const useTex = _texture.Use();
+        // The pending rows end just before the head; each lands at its own ring row, so nothing else moves.
+        for (std::size_t i = static_cast<std::size_t>(pending); i > 0; --i) {
+            std::size_t const row = (history.GetHead() + _rows - i) % _rows;
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, static_cast<GLint>(row), static_cast<GLsizei>(_bins), 1, GL_RED, GL_FLOAT, history.GetRingRow(row));
+        }
+        _syncedPushes = history.GetPushCount();
+        _lastUploadRows = static_cast<std::size_t>(pending);
+    }
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <glad/glad.h>
+#include <imgui.h>
+
+#include "Apps/SphereAudioVisualizer/SpectrogramHistory.hpp"
+#include "Engine/GL/Texture.hpp"
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    /**
+     * GPU copy of a SpectrogramHistory: an R16F texture, bins wide and rows high, with GL_REPEAT along v.
+     * Sync uploads only the rows pushed since the last call, normally one, with glTexSubImage2D, and
+     * reuploads everything after a resize. The volume pass binds it as uSpectrogramTex (unit 6) with
+     * uSpectrogramOffset = SpectrogramHistory::GetWrapOffset and samples v = offset + age.
+     */
+    class SpectrogramTexture {
+    public:
+        void Sync(SpectrogramHistory const & history);
+
+        GLuint GetTextureId() const { return _texture.Get(); }
+        ImTextureID GetImTextureId() const { return reinterpret_cast<ImTextureID>(std::uintptr_t(_texture.Get())); }
+        std::size_t GetRowsUploadedLastSync() const { return _lastUploadRows; }
+
+    private:
+        void Allocate(SpectrogramHistory const & history);
+
+        VCX::Engine::GL::UniqueTexture2D _texture;
+        std::size_t _bins = 0;
+        std::size_t _rows = 0;
+        std::uint64_t _syncedPushes = 0;
+        std::size_t _lastUploadRows = 0;
+    };
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -13,12 +13,11 @@ namespace VCX::Apps::SphereAudioVisualizer {
         constexpr float        kMaxAmpScale   = 5.f;
         constexpr float        kMinGlobalGain = 0.1f;
         constexpr float        kMaxGlobalGain = 5.f;
-        constexpr float        kMinSmoothing  = 0.f;
-        constexpr float        kMaxSmoothing  = 1.f;
         constexpr float        kMinTilt       = -1.f;
         constexpr float        kMaxTilt       = 1.f;
         constexpr float        kMinRadius     = 0.05f;
         constexpr float        kMaxRadius     = 1.f;
+        constexpr float        kShellDensityFloor = 1.f / 1024.f; // well under half an R8 step
 
         inline VCX::Engine::GL::SamplerOptions MakeSamplerOptions() {
             return VCX::Engine::GL::SamplerOptions {
@@ -45,8 +44,10 @@ namespace VCX::Apps::SphereAudioVisualizer {
         settings.ThicknessScale = std::clamp(settings.ThicknessScale, 0.f, 5.f);
         settings.BaseThickness  = std::clamp(settings.BaseThickness, kMinThickness, kMaxBaseThickness);
         settings.GlobalGain     = std::clamp(settings.GlobalGain, kMinGlobalGain, kMaxGlobalGain);
-        settings.SmoothingFactor = std::clamp(settings.SmoothingFactor, kMinSmoothing, kMaxSmoothing);
         settings.Tilt           = std::clamp(settings.Tilt, kMinTilt, kMaxTilt);
+        settings.StereoPan      = std::clamp(settings.StereoPan, 0.f, 1.f);
+        settings.StereoWidth    = std::clamp(settings.StereoWidth, 0.f, 1.f);
+        settings.OnsetKick      = std::clamp(settings.OnsetKick, 0.f, 1.f);
         _settings = settings;
         EnsureBandTables(_bandCount);
     }
@@ -58,10 +59,11 @@ namespace VCX::Apps::SphereAudioVisualizer {
         _volume = Engine::Texture3D<Engine::Formats::R8>(_settings.VolumeSize, _settings.VolumeSize, _settings.VolumeSize);
         _sliceIndex = std::clamp(_sliceIndex, std::size_t{0}, _settings.VolumeSize == 0 ? 0 : _settings.VolumeSize - 1);
         EnsureBandTables(_bandCount);
+        EnsureVoxelCells();
         UpdateSliceTexture();
     }
 
-    SphereVolumeData::BuildStats SphereVolumeData::UpdateVolume(std::vector<float> const & energies) {
+    SphereVolumeData::BuildStats SphereVolumeData::UpdateVolume(std::vector<float> const & energies, std::vector<float> const & angular) {
         BuildStats stats;
         if (_settings.VolumeSize == 0) {
             return stats;
@@ -71,22 +73,15 @@ namespace VCX::Apps::SphereAudioVisualizer {
         if (desiredBands != _bandCount) {
             EnsureBandTables(desiredBands);
         }
-        if (_smoothedEnergies.size() != _bandCount) {
-            _smoothedEnergies.assign(_bandCount, 0.f);
-        }
-
-        float smoothing = std::clamp(_settings.SmoothingFactor, kMinSmoothing, kMaxSmoothing);
-        for (std::size_t i = 0; i < _bandCount; ++i) {
-            float current = (i < energies.size()) ? energies[i] : 0.f;
-            if (smoothing >= 1.f) {
-                _smoothedEnergies[i] = current;
-            } else {
-                _smoothedEnergies[i] += smoothing * (current - _smoothedEnergies[i]);
-            }
-        }
+        CopyBands(energies, _energies, _bandCount);
 
         auto const buildStart = std::chrono::high_resolution_clock::now();
-        BuildVolume(_smoothedEnergies);
+        if (_voxelCells.size() != _settings.VolumeSize * _settings.VolumeSize * _settings.VolumeSize) {
+            EnsureVoxelCells();
+        }
+        _buckets.ComputeScales(angular, _bandCount, _cellScales);
+        ComputeShellIntervals(_settings, _energies, _bandBaseRadius, _bandGains, _cellScales, _bandCount, _shellIntervals);
+        BuildVolume(_energies);
         auto const buildEnd = std::chrono::high_resolution_clock::now();
         stats.BuildMs = std::chrono::duration<float, std::milli>(buildEnd - buildStart).count();
 
@@ -123,6 +118,10 @@ namespace VCX::Apps::SphereAudioVisualizer {
         return _volumeTexture.Get();
     }
 
+    GLuint SphereVolumeData::GetBrickTextureId() const {
+        return _brickTexture.Get();
+    }
+
     void SphereVolumeData::BuildVolume(std::vector<float> const & energies) {
         if (_settings.VolumeSize == 0) {
             return;
@@ -131,18 +130,27 @@ namespace VCX::Apps::SphereAudioVisualizer {
         auto const step = size > 1 ? 2.f / float(size - 1) : 0.f;
         auto const baseThickness = std::max(_settings.BaseThickness, kMinThickness);
         auto const globalGain = std::clamp(_settings.GlobalGain, kMinGlobalGain, kMaxGlobalGain);
+        auto const grid = BrickGridSize(size);
+        _brickRanges.resize(grid * grid * grid * 2);
+        for (std::size_t i = 0; i < _brickRanges.size(); i += 2) {
+            _brickRanges[i] = 1.f;
+            _brickRanges[i + 1] = 0.f;
+        }
 
         for (std::size_t z = 0; z < size; ++z) {
             auto const zn = size > 1 ? -1.f + step * z : 0.f;
             for (std::size_t y = 0; y < size; ++y) {
                 auto const yn = size > 1 ? -1.f + step * y : 0.f;
+                float * brickRow = _brickRanges.data() + ((z / kBrickSize) * grid + y / kBrickSize) * grid * 2;
                 for (std::size_t x = 0; x < size; ++x) {
                     auto const xn = size > 1 ? -1.f + step * x : 0.f;
                     auto const radius = std::sqrt(xn * xn + yn * yn + zn * zn);
+                    // Angular shape of every band in this voxel's direction, from the per-frame cell table.
+                    float const * scales = _cellScales.data() + std::size_t(_voxelCells[(z * size + y) * size + x]) * _bandCount;
                     float density = 0.f;
                     for (std::size_t band = 0; band < _bandCount; ++band) {
                         float energy = band < energies.size() ? energies[band] : 0.f;
-                        float radiusTarget = _bandBaseRadius[band] * (1.f + _settings.AmpScale * energy);
+                        float radiusTarget = _bandBaseRadius[band] * (1.f + _settings.AmpScale * energy) * scales[band];
                         float thickness = baseThickness * (1.f + _settings.ThicknessScale * energy);
                         thickness = std::max(thickness, kMinThickness);
                         float delta = (radius - radiusTarget) / thickness;
@@ -150,6 +158,88 @@ namespace VCX::Apps::SphereAudioVisualizer {
                     }
                     float value = std::clamp(density * globalGain, 0.f, 1.f);
                     _volume.At(x, y, z) = value;
+                    float * range = brickRow + (x / kBrickSize) * 2;
+                    range[0] = std::min(range[0], value);
+                    range[1] = std::max(range[1], value);
+                }
+            }
+        }
+    }
+
+    void SphereVolumeData::ComputeShellIntervals(
+        Settings const & settings,
+        std::vector<float> const & energies,
+        std::vector<float> const & baseRadius,
+        std::vector<float> const & gains,
+        std::vector<float> const & cellScales,
+        std::size_t numBands,
+        std::vector<ShellInterval> & out) {
+        out.clear();
+        numBands = std::min({ numBands, energies.size(), baseRadius.size(), gains.size() });
+        std::size_t const cells = numBands > 0 ? cellScales.size() / numBands : 0;
+        auto const size = std::max<std::size_t>(settings.VolumeSize, 2);
+        // The builder spans [-1, 1] between the outer voxel centres; the raymarcher between the outer faces.
+        float const toWorld = float(size - 1) / float(size);
+        float const ampScale = std::clamp(settings.AmpScale, 0.f, kMaxAmpScale);
+        float const thicknessScale = std::clamp(settings.ThicknessScale, 0.f, 5.f);
+        float const baseThickness = std::max(settings.BaseThickness, kMinThickness);
+        float const globalGain = std::clamp(settings.GlobalGain, kMinGlobalGain, kMaxGlobalGain);
+
+        for (std::size_t band = 0; band < numBands; ++band) {
+            float const energy = energies[band];
+            float const peak = gains[band] * energy * globalGain;
+            if (peak <= kShellDensityFloor) continue;
+            float lo = 1.f;
+            float hi = 1.f;
+            for (std::size_t cell = 0; cell < cells; ++cell) {
+                float const scale = cellScales[cell * numBands + band];
+                lo = std::min(lo, scale);
+                hi = std::max(hi, scale);
+            }
+            float const radiusTarget = baseRadius[band] * (1.f + ampScale * energy);
+            float const thickness = std::max(baseThickness * (1.f + thicknessScale * energy), kMinThickness);
+            float const reach = thickness * std::sqrt(std::log(peak / kShellDensityFloor));
+            out.push_back({ std::max(radiusTarget * lo - reach, 0.f) * toWorld, (radiusTarget * hi + reach) * toWorld });
+        }
+
+        std::sort(out.begin(), out.end(), [](ShellInterval const & a, ShellInterval const & b) { return a.Min < b.Min; });
+        std::size_t merged = 0;
+        for (std::size_t i = 0; i < out.size(); ++i) {
+            if (merged > 0 && out[i].Min <= out[merged - 1].Max) {
+                out[merged - 1].Max = std::max(out[merged - 1].Max, out[i].Max);
+            } else {
+                out[merged++] = out[i];
+            }
+        }
+        out.resize(merged);
+        // Too many to ship: close the narrowest gaps, which only ever adds empty space to march.
+        while (out.size() > kMaxShellIntervals) {
+            std::size_t narrowest = 0;
+            for (std::size_t i = 1; i + 1 < out.size(); ++i) {
+                if (out[i + 1].Min - out[i].Max < out[narrowest + 1].Min - out[narrowest].Max) narrowest = i;
+            }
+            out[narrowest].Max = out[narrowest + 1].Max;
+            out.erase(out.begin() + std::ptrdiff_t(narrowest + 1));
+        }
+    }
+
+    void SphereVolumeData::CopyBands(std::vector<float> const & src, std::vector<float> & dst, std::size_t count) {
+        dst.assign(count, 0.f);
+        std::copy_n(src.begin(), std::min(src.size(), count), dst.begin());
+    }
+
+    void SphereVolumeData::EnsureVoxelCells() {
+        auto const size = _settings.VolumeSize;
+        _buckets.Configure(size);
+        _voxelCells.resize(size * size * size);
+        auto const step = size > 1 ? 2.f / float(size - 1) : 0.f;
+        for (std::size_t z = 0; z < size; ++z) {
+            auto const zn = size > 1 ? -1.f + step * z : 0.f;
+            for (std::size_t y = 0; y < size; ++y) {
+                auto const yn = size > 1 ? -1.f + step * y : 0.f;
+                for (std::size_t x = 0; x < size; ++x) {
+                    auto const xn = size > 1 ? -1.f + step * x : 0.f;
+                    _voxelCells[(z * size + y) * size + x] = static_cast<std::uint16_t>(_buckets.CellOf(xn, yn, zn));
                 }
             }
         }
@@ -161,6 +251,49 @@ namespace VCX::Apps::SphereAudioVisualizer {
         }
         _volumeTexture.UpdateSampler(MakeSamplerOptions());
         _volumeTexture.Update(_volume);
+        UploadBrickTexture();
+    }
+
+    void SphereVolumeData::UploadBrickTexture() {
+        auto const grid = BrickGridSize(_settings.VolumeSize);
+        if (_brickRanges.size() != grid * grid * grid * 2) {
+            return;
+        }
+        // Widen every brick to its 3^3 neighbourhood; the grid is small enough for the direct loop.
+        _brickTexels.resize(_brickRanges.size());
+        auto const last = static_cast<std::ptrdiff_t>(grid) - 1;
+        for (std::size_t z = 0; z < grid; ++z) {
+            for (std::size_t y = 0; y < grid; ++y) {
+                for (std::size_t x = 0; x < grid; ++x) {
+                    float lo = 1.f;
+                    float hi = 0.f;
+                    for (std::ptrdiff_t dz = -1; dz <= 1; ++dz) {
+                        auto const nz = static_cast<std::size_t>(std::clamp(static_cast<std::ptrdiff_t>(z) + dz, std::ptrdiff_t(0), last));
+                        for (std::ptrdiff_t dy = -1; dy <= 1; ++dy) {
+                            auto const ny = static_cast<std::size_t>(std::clamp(static_cast<std::ptrdiff_t>(y) + dy, std::ptrdiff_t(0), last));
+                            for (std::ptrdiff_t dx = -1; dx <= 1; ++dx) {
+                                auto const nx = static_cast<std::size_t>(std::clamp(static_cast<std::ptrdiff_t>(x) + dx, std::ptrdiff_t(0), last));
+                                float const * range = _brickRanges.data() + ((nz * grid + ny) * grid + nx) * 2;
+                                lo = std::min(lo, range[0]);
+                                hi = std::max(hi, range[1]);
+                            }
+                        }
+                    }
+                    float * texel = _brickTexels.data() + ((z * grid + y) * grid + x) * 2;
+                    texel[0] = lo;
+                    texel[1] = hi;
+                }
+            }
+        }
+
+        auto const useTex = _brickTexture.Use();
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        auto const extent = static_cast<GLsizei>(grid);
+        glTexImage3D(GL_TEXTURE_3D, 0, GL_RG16F, extent, extent, extent, 0, GL_RG, GL_FLOAT, _brickTexels.data());
     }
 
     void SphereVolumeData::UpdateSliceTexture() {
@@ -184,8 +317,7 @@ namespace VCX::Apps::SphereAudioVisualizer {
         _bandCount = bandCount;
         _bandBaseRadius.resize(_bandCount);
         _bandGains.resize(_bandCount);
-        _smoothedEnergies.resize(_bandCount);
-        std::fill(_smoothedEnergies.begin(), _smoothedEnergies.end(), 0.f);
+        _energies.assign(_bandCount, 0.f);
 
         float logMin = std::log(kMinRadius);
         float logMax = std::log(kMaxRadius);
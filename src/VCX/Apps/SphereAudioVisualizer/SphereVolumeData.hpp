@@ -6,6 +6,7 @@
 
 #include <imgui.h>
 
+#include "Apps/SphereAudioVisualizer/SphericalHarmonics.hpp"
 #include "Engine/GL/Texture.hpp"
 #include "Engine/TextureND.hpp"
 
@@ -23,8 +24,10 @@ namespace VCX::Apps::SphereAudioVisualizer {
             float ThicknessScale = 1.f;
             float BaseThickness = 0.08f;
             float GlobalGain = 1.f;
-            float SmoothingFactor = 0.2f;
             float Tilt = 0.f;
+            float StereoPan = 0.5f;   // how far a panned band pushes its shell out on that side
+            float StereoWidth = 0.3f; // how far a wide band stretches its shell left and right
+            float OnsetKick = 0.2f;   // how far an onset lifts the shells of its part of the spectrum
             RadiusDistribution RadiusLayout = RadiusDistribution::Linear;
         };
 
@@ -33,12 +36,41 @@ namespace VCX::Apps::SphereAudioVisualizer {
             float UploadMs = 0.f;
         };
 
+        /**
+         * Bricks of kBrickSize^3 voxels hold the min and max density of their 3^3-brick neighbourhood, so a
+         * brick that is empty stays empty for any sample warped or filtered by less than one brick.
+         */
+        static constexpr std::size_t kBrickSize = 8;
+        static std::size_t BrickGridSize(std::size_t volumeSize) { return (volumeSize + kBrickSize - 1) / kBrickSize; }
+
+        // Radii, in the raymarcher's world units, between which the band shells can add density.
+        struct ShellInterval {
+            float Min = 0.f;
+            float Max = 0.f;
+        };
+        static constexpr std::size_t kMaxShellIntervals = 32; // nearest intervals merge beyond this
+
+        /**
+         * Each band reaches radiusTarget * scale +- k * thickness, with k where its Gaussian falls below a
+         * density floor and scale spanning the band's angular cells in cellScales (cells x numBands).
+         * Overlapping bands merge, so out holds sorted, disjoint intervals.
+         */
+        static void ComputeShellIntervals(
+            Settings const & settings,
+            std::vector<float> const & energies,
+            std::vector<float> const & baseRadius,
+            std::vector<float> const & gains,
+            std::vector<float> const & cellScales,
+            std::size_t numBands,
+            std::vector<ShellInterval> & out);
+
         SphereVolumeData();
 
         Settings const & GetSettings() const;
         void SetSettings(Settings settings);
         void Regenerate();
-        BuildStats UpdateVolume(std::vector<float> const & energies);
+        // angular holds kShCoeffs spherical-harmonic coefficients per band; empty keeps the shells round.
+        BuildStats UpdateVolume(std::vector<float> const & energies, std::vector<float> const & angular);
 
         void SetSliceIndex(std::size_t index);
         std::size_t GetSliceIndex() const;
@@ -46,6 +78,8 @@ namespace VCX::Apps::SphereAudioVisualizer {
 
         ImTextureID GetSliceTextureHandle() const;
         GLuint GetVolumeTextureId() const;
+        GLuint GetBrickTextureId() const; // RG16F min / max per brick
+        std::vector<ShellInterval> const & GetShellIntervals() const { return _shellIntervals; }
 
     private:
         Settings                                     _settings;
@@ -56,10 +90,20 @@ namespace VCX::Apps::SphereAudioVisualizer {
         std::size_t                                  _bandCount = 0;
         std::vector<float>                           _bandBaseRadius;
         std::vector<float>                           _bandGains;
-        std::vector<float>                           _smoothedEnergies;
+        std::vector<float>                           _energies;
+        DirectionBuckets                             _buckets;
+        std::vector<std::uint16_t>                   _voxelCells;  // direction cell of every voxel
+        std::vector<float>                           _cellScales;  // cells x bands radius scale
+        VCX::Engine::GL::UniqueTexture3D             _brickTexture;
+        std::vector<float>                           _brickRanges; // min, max per brick, before dilation
+        std::vector<float>                           _brickTexels; // min, max per brick, dilated
+        std::vector<ShellInterval>                   _shellIntervals;
 
         void BuildVolume(std::vector<float> const & energies);
+        static void CopyBands(std::vector<float> const & src, std::vector<float> & dst, std::size_t count);
+        void EnsureVoxelCells();
         void UploadVolumeTexture();
+        void UploadBrickTexture();
         void UpdateSliceTexture();
 
         void EnsureBandTables(std::size_t bandCount);
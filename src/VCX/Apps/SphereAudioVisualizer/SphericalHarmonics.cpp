@@ -0,0 +1,135 @@
+#include "Apps/SphereAudioVisualizer/SphericalHarmonics.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    namespace {
+        constexpr int kMinResolution = 16;
+        constexpr int kMaxResolution = 64;
+
+        // Centre direction of an octahedral map cell; the inverse of the folding in CellOf.
+        void CellDirection(int u, int v, int resolution, float & x, float & y, float & z) {
+            float px = (static_cast<float>(u) + 0.5f) / static_cast<float>(resolution) * 2.f - 1.f;
+            float py = (static_cast<float>(v) + 0.5f) / static_cast<float>(resolution) * 2.f - 1.f;
+            float pz = 1.f - std::abs(px) - std::abs(py);
+            if (pz < 0.f) {
+                float const fx = (1.f - std::abs(py)) * (px >= 0.f ? 1.f : -1.f);
+                float const fy = (1.f - std::abs(px)) * (py >= 0.f ? 1.f : -1.f);
+                px = fx;
+                py = fy;
+            }
+            float const length = std::sqrt(px * px + py * py + pz * pz);
+            x = px / length;
+            y = py / length;
+            z = pz / length;
+        }
+
+        // scales = basis (cells x kShCoeffs) * coefficients^T (kShCoeffs x bands), offset by 1 and clamped.
+        void MultiplyBasis(
+            float const * __restrict basis,
+            float const * __restrict coefficients,
+            float * __restrict scales,
+            std::size_t cells,
+            std::size_t numBands) {
+            for (std::size_t cell = 0; cell < cells; ++cell) {
+                float const * row = basis + cell * kShCoeffs;
+                float * out = scales + cell * numBands;
+                for (std::size_t band = 0; band < numBands; ++band) {
+                    float const * c = coefficients + band * kShCoeffs;
+                    float value = 1.f;
+                    for (std::size_t j = 0; j < kShCoeffs; ++j) {
+                        value += row[j] * c[j];
+                    }
+                    out[band] = value > DirectionBuckets::kMinScale ? value : DirectionBuckets::kMinScale;
+                }
+            }
+        }
+    }
+
+    void EvaluateShBasis(float x, float y, float z, float * out) {
+        out[0] = 1.f;
+        out[1] = y;
+        out[2] = z;
+        out[3] = x;
+        out[4] = x * y;
+        out[5] = y * z;
+        out[6] = 3.f * z * z - 1.f;
+        out[7] = x * z;
+        out[8] = x * x - y * y;
+    }
+
+    int DirectionBuckets::ResolutionFor(std::size_t volumeSize) {
+        // About one cell per three voxels across the outer shell.
+        return std::clamp(static_cast<int>(volumeSize / 3), kMinResolution, kMaxResolution);
+    }
+
+    void DirectionBuckets::Configure(std::size_t volumeSize) {
+        int const resolution = ResolutionFor(volumeSize);
+        if (resolution == _resolution) return;
+        _resolution = resolution;
+        _basis.resize(GetCount() * kShCoeffs);
+        for (int v = 0; v < resolution; ++v) {
+            for (int u = 0; u < resolution; ++u) {
+                float x = 0.f;
+                float y = 0.f;
+                float z = 0.f;
+                CellDirection(u, v, resolution, x, y, z);
+                std::size_t const cell = static_cast<std::size_t>(v) * static_cast<std::size_t>(resolution) + static_cast<std::size_t>(u);
+                EvaluateShBasis(x, y, z, _basis.data() + cell * kShCoeffs);
+            }
+        }
+    }
+
+    std::uint32_t DirectionBuckets::CellOf(float x, float y, float z) const {
+        float const sum = std::abs(x) + std::abs(y) + std::abs(z);
+        if (sum <= 0.f || _resolution <= 0) return 0;
+        float px = x / sum;
+        float py = y / sum;
+        if (z < 0.f) {
+            float const fx = (1.f - std::abs(py)) * (px >= 0.f ? 1.f : -1.f);
+            float const fy = (1.f - std::abs(px)) * (py >= 0.f ? 1.f : -1.f);
+            px = fx;
+            py = fy;
+        }
+        float const r = static_cast<float>(_resolution);
+        int const u = std::clamp(static_cast<int>((px * 0.5f + 0.5f) * r), 0, _resolution - 1);
+        int const v = std::clamp(static_cast<int>((py * 0.5f + 0.5f) * r), 0, _resolution - 1);
+        return static_cast<std::uint32_t>(v * _resolution + u);
+    }
+
+    void DirectionBuckets::ComputeScales(std::vector<float> const & coefficients, std::size_t numBands, std::vector<float> & scales) const {
+        std::size_t const cells = GetCount();
+        scales.resize(cells * numBands);
+        std::size_t const given = std::min(numBands, coefficients.size() / kShCoeffs);
+        if (given < numBands) {
+            std::fill(scales.begin(), scales.end(), 1.f);
+        }
+        if (given == 0) return;
+        if (given == numBands) {
+            MultiplyBasis(_basis.data(), coefficients.data(), scales.data(), cells, numBands);
+            return;
+        }
+        // Fewer coefficients than bands: pad with round shells rather than reading past the input.
+        std::vector<float> padded(numBands * kShCoeffs, 0.f);
+        std::copy_n(coefficients.begin(), given * kShCoeffs, padded.begin());
+        MultiplyBasis(_basis.data(), padded.data(), scales.data(), cells, numBands);
+    }
+
+    void ComposeAngularCoefficients(AngularSources const & sources, std::size_t numBands, std::vector<float> & out) {
+        out.assign(numBands * kShCoeffs, 0.f);
+        for (std::size_t band = 0; band < numBands; ++band) {
+            float * c = out.data() + band * kShCoeffs;
+            float const pan = sources.Pan && band < sources.Pan->size() ? (*sources.Pan)[band] : 0.f;
+            float const width = sources.Width && band < sources.Width->size() ? (*sources.Width)[band] : 0.f;
+            std::size_t const group = std::min<std::size_t>(band * 3 / std::max<std::size_t>(numBands, 1), 2);
+
+            c[3] = sources.PanGain * pan;
+            float const stretch = sources.WidthGain * width;
+            c[0] = stretch / 3.f;
+            c[8] = stretch * 0.5f;
+            c[6] = -stretch / 6.f;
+            c[1] = sources.OnsetGain * sources.OnsetPulse[group];
+        }
+    }
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    /**
+     * Real spherical harmonics up to l = 2, in unnormalised Cartesian form so a coefficient reads as a
+     * plain radius change: { 1, y, z, x, xy, yz, 3z^2 - 1, xz, x^2 - y^2 } at the unit direction (x, y, z).
+     */
+    inline constexpr std::size_t kShCoeffs = 9;
+
+    void EvaluateShBasis(float x, float y, float z, float * out);
+
+    /**
+     * Directions quantised to the cells of an octahedral map, so the angular shape of every band is
+     * evaluated once per cell instead of once per voxel. The resolution follows the volume size. The
+     * basis table (cells x kShCoeffs) is built once per resolution, and a frame is one mat-vec of it
+     * against the band coefficients. spherevis_build_volume.comp repeats OctahedralCell exactly.
+     */
+    class DirectionBuckets {
+    public:
+        static constexpr float kMinScale = 0.2f; // shells never fold through the centre
+
+        static int ResolutionFor(std::size_t volumeSize);
+
+        // Rebuild the basis table for the resolution that suits volumeSize; cheap when it is unchanged.
+        void Configure(std::size_t volumeSize);
+
+        int GetResolution() const { return _resolution; }
+        std::size_t GetCount() const { return static_cast<std::size_t>(_resolution) * static_cast<std::size_t>(_resolution); }
+        std::uint32_t CellOf(float x, float y, float z) const;
+
+        /**
+         * scales[cell * numBands + band] = max(kMinScale, 1 + coefficients of band . basis of cell).
+         * coefficients holds kShCoeffs per band, band after band; missing bands stay round.
+         */
+        void ComputeScales(std::vector<float> const & coefficients, std::size_t numBands, std::vector<float> & scales) const;
+
+    private:
+        int _resolution = 0;
+        std::vector<float> _basis; // cells x kShCoeffs
+    };
+
+    struct AngularSources {
+        std::vector<float> const * Pan = nullptr;   // -1..1 per band
+        std::vector<float> const * Width = nullptr; // 0..1 per band
+        std::array<float, 3> OnsetPulse {};         // low / mid / high onset groups, 0..1
+        float PanGain = 0.f;
+        float WidthGain = 0.f;
+        float OnsetGain = 0.f;
+    };
+
+    /**
+     * Per-band coefficients from the analysis features: pan leans a shell along x, width stretches it
+     * along x (x^2 = (x^2 - y^2) / 2 + 1/3 - (3z^2 - 1) / 6), and an onset in a band's third of the spectrum
+     * kicks it up along y.
+     */
+    void ComposeAngularCoefficients(AngularSources const & sources, std::size_t numBands, std::vector<float> & out);
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -0,0 +1,147 @@
+#include "Apps/SphereAudioVisualizer/StereoSpectrum.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    namespace {
+        constexpr float kSilence = 1e-14f;      // band power below this keeps the previous pan and width
+        constexpr float kSingleChannel = 1e-3f; // sqrt(L R) / (L + R) below this counts as one channel
+
+        void PackChannels(
+            float const * __restrict left,
+            float const * __restrict right,
+            float const * __restrict coeffs,
+            kiss_fft_cpx * __restrict fftIn,
+            float meanLeft,
+            float meanRight,
+            std::size_t n) {
+            for (std::size_t i = 0; i < n; ++i) {
+                fftIn[i].r = (left[i] - meanLeft) * coeffs[i];
+                fftIn[i].i = (right[i] - meanRight) * coeffs[i];
+            }
+        }
+
+        // Split bins [1, half) of the packed transform into per-channel power, cross power and mid power.
+        // mirror points at Z[N - 1], so mirror[-k] is Z[N - 1 - k] and bin k pairs with mirror[1 - k].
+        // The square root is left to a separate pass: its errno path would keep this loop scalar.
+        void SplitChannels(
+            kiss_fft_cpx const * __restrict z,
+            kiss_fft_cpx const * __restrict mirror,
+            float * __restrict powerLeft,
+            float * __restrict powerRight,
+            float * __restrict cross,
+            float * __restrict midPower,
+            float midRightWeight,
+            std::size_t half) {
+            for (std::size_t k = 1; k < half; ++k) {
+                std::ptrdiff_t const m = 1 - static_cast<std::ptrdiff_t>(k);
+                float const ar = z[k].r;
+                float const ai = z[k].i;
+                float const br = mirror[m].r;
+                float const bi = mirror[m].i;
+                float const lr = 0.5f * (ar + br);
+                float const li = 0.5f * (ai - bi);
+                float const rr = 0.5f * (ai + bi);
+                float const ri = 0.5f * (br - ar);
+                powerLeft[k] = lr * lr + li * li;
+                powerRight[k] = rr * rr + ri * ri;
+                cross[k] = lr * rr + li * ri;
+                float const mr = lr + midRightWeight * (rr - lr);
+                float const mi = li + midRightWeight * (ri - li);
+                midPower[k] = mr * mr + mi * mi;
+            }
+        }
+    }
+
+    StereoSpectrum::~StereoSpectrum() {
+        if (_cfg) {
+            kiss_fft_free(_cfg);
+            _cfg = nullptr;
+        }
+    }
+
+    void StereoSpectrum::Configure(AudioAnalysisSettings const & settings, int fftSize, std::uint32_t sampleRate) {
+        int const numBands = std::clamp(settings.NumBands, 1, 256);
+        if (fftSize == _fftSize && sampleRate == _sampleRate && numBands == _numBands
+            && settings.Mapping == _mapping && settings.MinFrequency == _minFrequency) {
+            return;
+        }
+        if (fftSize != _fftSize) {
+            if (_cfg) kiss_fft_free(_cfg);
+            _cfg = kiss_fft_alloc(fftSize, 0, nullptr, nullptr);
+            std::size_t const size = static_cast<std::size_t>(fftSize);
+            _fftIn.resize(size);
+            _fftOut.resize(size);
+            _powerLeft.assign(size / 2, 0.f);
+            _powerRight.assign(size / 2, 0.f);
+            _cross.assign(size / 2, 0.f);
+            _mid.assign(size / 2, 0.f);
+        }
+        _fftSize = fftSize;
+        _sampleRate = sampleRate;
+        _numBands = numBands;
+        _mapping = settings.Mapping;
+        _minFrequency = settings.MinFrequency;
+        _ranges.resize(static_cast<std::size_t>(numBands));
+        for (int b = 0; b < numBands; ++b) {
+            _ranges[static_cast<std::size_t>(b)] = ComputeBandRange(settings, b, numBands, fftSize, static_cast<int>(std::max<std::uint32_t>(sampleRate, 1)));
+        }
+        _pan.assign(static_cast<std::size_t>(numBands), 0.f);
+        _width.assign(static_cast<std::size_t>(numBands), 0.f);
+        _balance = 0.f;
+    }
+
+    void StereoSpectrum::Process(float const * left, float const * right, std::vector<float> const & coeffs, bool midFromLeft, float deltaTime) {
+        std::size_t const n = static_cast<std::size_t>(_fftSize);
+        if (_cfg == nullptr || n < 4 || coeffs.size() < n) return;
+
+        WindowStats const statsLeft = MeasureWindow(left, n);
+        WindowStats const statsRight = MeasureWindow(right, n);
+        PackChannels(left, right, coeffs.data(), _fftIn.data(), statsLeft.Mean, statsRight.Mean, n);
+        kiss_fft(_cfg, _fftIn.data(), _fftOut.data());
+
+        // DC pairs with itself: its real part is the left channel's, its imaginary part the right's.
+        float const scale = 1.f / static_cast<float>(n);
+        float const midRightWeight = midFromLeft ? 0.f : 0.5f;
+        kiss_fft_cpx const dc = _fftOut[0];
+        _powerLeft[0] = dc.r * dc.r;
+        _powerRight[0] = dc.i * dc.i;
+        _cross[0] = dc.r * dc.i;
+        _mid[0] = std::abs(dc.r + midRightWeight * (dc.i - dc.r)) * scale;
+        SplitChannels(_fftOut.data(), _fftOut.data() + (n - 1), _powerLeft.data(), _powerRight.data(), _cross.data(), _mid.data(), midRightWeight, n / 2);
+        for (std::size_t k = 1; k < n / 2; ++k) {
+            _mid[k] = std::sqrt(_mid[k]) * scale;
+        }
+
+        float const blend = 1.f - std::exp(-std::max(deltaTime, 0.f) / kSmoothingSeconds);
+        float totalLeft = 0.f;
+        float totalRight = 0.f;
+        int const bins = static_cast<int>(n / 2);
+        for (std::size_t b = 0; b < _ranges.size(); ++b) {
+            float energyLeft = 0.f;
+            float energyRight = 0.f;
+            float crossSum = 0.f;
+            for (int i = std::max(_ranges[b].Start, 0); i < std::min(_ranges[b].End, bins); ++i) {
+                energyLeft += _powerLeft[static_cast<std::size_t>(i)];
+                energyRight += _powerRight[static_cast<std::size_t>(i)];
+                crossSum += _cross[static_cast<std::size_t>(i)];
+            }
+            totalLeft += energyLeft;
+            totalRight += energyRight;
+            float const total = energyLeft + energyRight;
+            if (total <= kSilence) continue;
+            float const pan = (energyRight - energyLeft) / total;
+            // A band heard in one channel only is coherent, not wide, even though its correlation is undefined.
+            float const geometric = std::sqrt(energyLeft * energyRight);
+            float const correlation = geometric > kSingleChannel * total ? std::clamp(crossSum / geometric, -1.f, 1.f) : 1.f;
+            float const width = 0.5f * (1.f - correlation);
+            _pan[b] += blend * (pan - _pan[b]);
+            _width[b] += blend * (width - _width[b]);
+        }
+        float const total = totalLeft + totalRight;
+        if (total > kSilence) {
+            _balance += blend * ((totalRight - totalLeft) / total - _balance);
+        }
+    }
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Apps/SphereAudioVisualizer/AudioAnalysis.hpp"
+#include "kissfft/kiss_fft.h"
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    /**
+     * Left and right spectra from one complex FFT: the windowed left channel goes in the real part and the
+     * right channel in the imaginary part, and the conjugate symmetry of real signals separates them again
+     * (L[k] = (Z[k] + Z*[N-k]) / 2, R[k] = (Z[k] - Z*[N-k]) / 2i). Stereo therefore costs one transform,
+     * the same as the mono path. The mid spectrum it also produces replaces the mono one.
+     *
+     * Per band, pan comes from the channel energies and width from the normalised cross-spectrum. The
+     * cross-spectrum carries the inter-channel phase, so out-of-phase content reads wide even when both
+     * channels are equally loud.
+     */
+    class StereoSpectrum {
+    public:
+        static constexpr float kSmoothingSeconds = 0.08f;
+
+        StereoSpectrum() = default;
+        ~StereoSpectrum();
+        StereoSpectrum(StereoSpectrum const &) = delete;
+        StereoSpectrum & operator=(StereoSpectrum const &) = delete;
+
+        // Rebuild the transform and band ranges when the size, bands or sample rate changed; cheap otherwise.
+        void Configure(AudioAnalysisSettings const & settings, int fftSize, std::uint32_t sampleRate);
+
+        /**
+         * left and right hold fftSize samples each. Each channel's mean is removed while windowing.
+         * midFromLeft matches the mono ring when it carries only the left channel rather than the mix.
+         */
+        void Process(float const * left, float const * right, std::vector<float> const & coeffs, bool midFromLeft, float deltaTime);
+
+        std::vector<float> const & GetMidSpectrum() const { return _mid; }  // same scale as the mono path
+        std::vector<float> const & GetBandPan() const { return _pan; }      // -1 left .. 1 right
+        std::vector<float> const & GetBandWidth() const { return _width; }  // 0 mono, 0.5 uncorrelated, 1 out of phase
+        float GetBalance() const { return _balance; }                       // energy-weighted pan of all bands
+
+    private:
+        kiss_fft_cfg _cfg = nullptr;
+        int _fftSize = 0;
+        std::uint32_t _sampleRate = 0;
+        int _numBands = 0;
+        MappingType _mapping = MappingType::Log;
+        float _minFrequency = 0.f;
+
+        std::vector<BandRange> _ranges;
+        std::vector<kiss_fft_cpx> _fftIn;
+        std::vector<kiss_fft_cpx> _fftOut;
+        std::vector<float> _powerLeft;  // per bin
+        std::vector<float> _powerRight;
+        std::vector<float> _cross;      // Re(L R*)
+        std::vector<float> _mid;
+        std::vector<float> _pan;        // smoothed, per band
+        std::vector<float> _width;
+        float _balance = 0.f;
+    };
+} // namespace VCX::Apps::SphereAudioVisualizer
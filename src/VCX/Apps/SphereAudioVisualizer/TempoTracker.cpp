@@ -0,0 +1,159 @@
+#include "Apps/SphereAudioVisualizer/TempoTracker.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    void TempoTracker::Reset(float hopRate) {
+        _hopRate = std::max(hopRate, 1.f);
+        _acfDecay = std::exp(-1.f / (kMemorySeconds * _hopRate));
+        _meanCoeff = 1.f - std::exp(-1.f / (kMeanSeconds * _hopRate));
+        RebuildLags();
+    }
+
+    void TempoTracker::SetSettings(Settings const & settings) {
+        bool const rangeChanged = settings.MinBpm != _settings.MinBpm || settings.MaxBpm != _settings.MaxBpm;
+        bool const priorChanged = settings.PriorBpm != _settings.PriorBpm;
+        _settings = settings;
+        if (rangeChanged) {
+            RebuildLags();
+        } else if (priorChanged) {
+            UpdatePrior();
+        }
+    }
+
+    void TempoTracker::UpdatePrior() {
+        float const priorPeriod = 60.f * _hopRate / std::max(_settings.PriorBpm, 1.f);
+        for (std::size_t i = 0; i < _prior.size(); ++i) {
+            float const octaves = std::log2(static_cast<float>(_minLag + i) / priorPeriod);
+            _prior[i] = std::exp(-0.5f * octaves * octaves / (kPriorOctaves * kPriorOctaves));
+        }
+    }
+
+    void TempoTracker::RebuildLags() {
+        float const minBpm = std::clamp(_settings.MinBpm, 20.f, 400.f);
+        float const maxBpm = std::clamp(_settings.MaxBpm, minBpm + 1.f, 600.f);
+        _minLag = std::max<std::size_t>(2, static_cast<std::size_t>(std::floor(60.f * _hopRate / maxBpm)));
+        _maxLag = std::max(_minLag + 2, static_cast<std::size_t>(std::ceil(60.f * _hopRate / minBpm)));
+
+        _envelopeRing.assign(_maxLag + 1, 0.f);
+        _acf.assign(_maxLag - _minLag + 1, 0.f);
+        _prior.assign(_acf.size(), 0.f);
+        UpdatePrior();
+
+        _ringPos = 0;
+        _hopCount = 0;
+        _envelopeMean = 0.f;
+        _energy = 0.f;
+        _period = 60.f * _hopRate / std::max(_settings.PriorBpm, 1.f);
+        _candidatePeriod = 0.f;
+        _candidateCount = 0;
+        _phase = 0.f;
+        _confidence = 0.f;
+        _beatCount = 0;
+    }
+
+    void TempoTracker::ProcessHop(float envelope, float onsetWeight) {
+        if (_acf.empty()) {
+            return;
+        }
+
+        // Remove the slowly varying level so the autocorrelation sees the pulses only.
+        _envelopeMean += _meanCoeff * (envelope - _envelopeMean);
+        float const x = std::max(0.f, envelope - _envelopeMean);
+
+        std::size_t const ringSize = _envelopeRing.size();
+        _envelopeRing[_ringPos] = x;
+        _energy = _acfDecay * _energy + x * x;
+        std::size_t const available = static_cast<std::size_t>(std::min<std::uint64_t>(_hopCount, _maxLag));
+        for (std::size_t lag = _minLag; lag <= available; ++lag) {
+            float const past = _envelopeRing[(_ringPos + ringSize - lag) % ringSize];
+            auto & acf = _acf[lag - _minLag];
+            acf = _acfDecay * acf + x * past;
+        }
+        for (std::size_t lag = std::max(_minLag, available + 1); lag <= _maxLag; ++lag) {
+            _acf[lag - _minLag] *= _acfDecay;
+        }
+        _ringPos = (_ringPos + 1) % ringSize;
+        ++_hopCount;
+
+        if (_hopCount % kEstimateInterval == 0) {
+            EstimatePeriod();
+        }
+
+        _phase += 1.f / std::max(_period, 1.f);
+        if (_phase >= 1.f) {
+            _phase -= std::floor(_phase);
+            ++_beatCount;
+        }
+
+        if (onsetWeight > 0.f && _confidence >= kMinConfidence) {
+            float error = _phase >= 0.5f ? _phase - 1.f : _phase; // > 0: the clock runs ahead of the onset
+            if (std::abs(error) <= kPhaseWindow) {
+                _phase -= kPhaseGain * std::min(onsetWeight, 1.f) * _confidence * error;
+                _phase -= std::floor(_phase);
+            }
+        }
+    }
+
+    void TempoTracker::EstimatePeriod() {
+        if (_energy <= 1e-9f) {
+            _confidence = 0.f;
+            return;
+        }
+
+        // Score each lag with the prior and half the strength of its double, which suppresses octave errors.
+        std::size_t best = 0;
+        float bestScore = 0.f;
+        for (std::size_t i = 0; i < _acf.size(); ++i) {
+            std::size_t const doubled = 2 * (_minLag + i);
+            float score = _acf[i];
+            if (doubled <= _maxLag) {
+                score += 0.5f * _acf[doubled - _minLag];
+            }
+            score *= _prior[i];
+            if (score > bestScore) {
+                bestScore = score;
+                best = i;
+            }
+        }
+        if (bestScore <= 0.f) {
+            _confidence = 0.f;
+            return;
+        }
+
+        float offset = 0.f;
+        if (best > 0 && best + 1 < _acf.size()) {
+            float const left = _acf[best - 1];
+            float const centre = _acf[best];
+            float const right = _acf[best + 1];
+            float const denom = left - 2.f * centre + right;
+            if (denom < 0.f) {
+                offset = std::clamp(0.5f * (left - right) / denom, -0.5f, 0.5f);
+            }
+        }
+        float const estimate = static_cast<float>(_minLag + best) + offset;
+        _confidence = std::clamp(_acf[best] / _energy, 0.f, 1.f);
+        if (_confidence < kMinConfidence) {
+            return;
+        }
+
+        // Follow small drifts smoothly; jump to a new tempo only once several estimates agree on it.
+        if (std::abs(std::log(estimate / _period)) < 0.06f) {
+            _period += 0.25f * (estimate - _period);
+            _candidateCount = 0;
+        } else if (_candidateCount > 0 && std::abs(std::log(estimate / _candidatePeriod)) < 0.06f) {
+            if (++_candidateCount >= kSwitchEstimates) {
+                _period = estimate;
+                _candidateCount = 0;
+            }
+        } else {
+            _candidatePeriod = estimate;
+            _candidateCount = 1;
+        }
+    }
+
+    float TempoTracker::GetBpm() const {
+        return _period > 0.f ? 60.f * _hopRate / _period : 0.f;
+    }
+} // namespace VCX::Apps::SphereAudioVisualizer
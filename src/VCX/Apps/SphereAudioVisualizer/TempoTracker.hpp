@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace VCX::Apps::SphereAudioVisualizer {
+    /**
+     * Streaming tempo estimator and beat clock driven by the onset envelope, one call per analysis hop.
+     * A leaky autocorrelation over a fixed lag set (MinBpm..MaxBpm) picks the beat period; onsets near the
+     * predicted beat pull the phase of a free-running clock. Work per hop is bounded by the lag count.
+     */
+    class TempoTracker {
+    public:
+        struct Settings {
+            float MinBpm   = 60.f;
+            float MaxBpm   = 200.f;
+            float PriorBpm = 120.f; // centre of the log-Gaussian tempo prior
+        };
+
+        void Reset(float hopRate);
+        void SetSettings(Settings const & settings);
+        Settings const & GetSettings() const { return _settings; }
+
+        /**
+         * Advance one hop.
+         * @param envelope    onset envelope of the hop (rectified spectral flux).
+         * @param onsetWeight 0 when no onset was detected in the hop, otherwise its weight in (0, 1].
+         */
+        void ProcessHop(float envelope, float onsetWeight);
+
+        float GetBpm() const;
+        float GetBeatPhase() const { return _phase; } // [0, 1), 0 on the beat
+        float GetConfidence() const { return _confidence; }
+        std::uint64_t GetBeatCount() const { return _beatCount; }
+
+    private:
+        static constexpr float       kMemorySeconds      = 6.f;  // autocorrelation time constant
+        static constexpr float       kMeanSeconds        = 1.f;  // envelope mean removal time constant
+        static constexpr std::size_t kEstimateInterval   = 8;    // hops between period estimates
+        static constexpr float       kPriorOctaves       = 1.f;  // width of the tempo prior
+        static constexpr float       kPhaseGain          = 0.25f;
+        static constexpr float       kPhaseWindow        = 0.25f; // onsets further from a beat do not pull the phase
+        static constexpr float       kMinConfidence      = 0.1f;
+        static constexpr std::size_t kSwitchEstimates    = 3;    // agreeing estimates needed for a tempo jump
+
+        void RebuildLags();
+        void UpdatePrior();
+        void EstimatePeriod();
+
+        Settings _settings;
+        float _hopRate = 93.75f; // hops per second
+        std::size_t _minLag = 1;
+        std::size_t _maxLag = 1;
+
+        std::vector<float> _envelopeRing; // holds _maxLag + 1 past envelope values
+        std::vector<float> _acf;          // leaky autocorrelation for lags _minLag.._maxLag
+        std::vector<float> _prior;
+        std::size_t _ringPos = 0;
+        std::uint64_t _hopCount = 0;
+        float _acfDecay = 1.f;
+        float _meanCoeff = 0.f;
+        float _envelopeMean = 0.f;
+        float _energy = 0.f;
+
+        float _period = 0.f;       // beat period in hops
+        float _candidatePeriod = 0.f;
+        std::size_t _candidateCount = 0;
+        float _phase = 0.f;
+        float _confidence = 0.f;
+        std::uint64_t _beatCount = 0;
+    };
+} // namespace VCX::Apps::SphereAudioVisualizer
@@ -6,9 +6,10 @@
 #include <spdlog/spdlog.h>
 
 #include "Apps/SphereAudioVisualizer/App.hpp"
+#include "Apps/SphereAudioVisualizer/BatchAnalyzer.hpp"
 
 namespace {
-    using AppRunner = std::function<int()>;
+    using AppRunner = std::function<int(int, char **)>;
 
     std::string ParseSelectedApp(int const argc, char * argv[]) {
         std::string selected { "spherevis" };
@@ -29,8 +30,9 @@ int main(int argc, char * argv[]) {
     VCX::Apps::SphereAudioVisualizer::EnsureLogger();
 
     std::unordered_map<std::string, AppRunner> registry;
-    registry.emplace("spherevis", &VCX::Apps::SphereAudioVisualizer::RunApp);
-    registry.emplace("volumefx", [] {
+    registry.emplace("spherevis", [](int, char **) { return VCX::Apps::SphereAudioVisualizer::RunApp(); });
+    registry.emplace("analyze", &VCX::Apps::SphereAudioVisualizer::RunAnalyzeApp);
+    registry.emplace("volumefx", [](int, char **) {
         spdlog::error("VolumeFX app is not available in this build.");
         return 1;
     });
@@ -38,9 +40,9 @@ int main(int argc, char * argv[]) {
     auto selected = ParseSelectedApp(argc, argv);
     if (auto it = registry.find(selected); it != registry.end()) {
         spdlog::info("Launching app '{}'", it->first);
-        return it->second();
+        return it->second(argc, argv);
     }
 
     spdlog::warn("Unknown app '{}', defaulting to spherevis", selected);
-    return registry.at("spherevis")();
+    return registry.at("spherevis")(argc, argv);
 }
@@ -1,4 +1,6 @@
 #include <array>
+#include <string>
+#include <vector>
 
 #include <spdlog/spdlog.h>
 
@@ -12,6 +14,10 @@ namespace VCX::Engine::GL {
     }
 
     GLuint UniqueProgram::CreateProgramFromShaders(std::initializer_list<SharedShader> const & shaders) {
+        return CreateProgramFromShaders(std::span<SharedShader const>(shaders.begin(), shaders.size()));
+    }
+
+    GLuint UniqueProgram::CreateProgramFromShaders(std::span<SharedShader const> const shaders) {
         auto const program { glCreateProgram() };
         for (auto const & shader : shaders) {
             glAttachShader(program, shader.Get());
@@ -21,6 +27,18 @@ namespace VCX::Engine::GL {
         return program;
     }
 
+    UniqueProgram & ProgramPermutations::Get(std::vector<std::string> const & defines) {
+        std::string key;
+        for (auto const & define : defines) key += define + ';';
+        if (auto const it { _programs.find(key) }; it != _programs.end()) return it->second;
+
+        std::vector<SharedShader> shaders;
+        shaders.reserve(_paths.size());
+        for (auto const & path : _paths) shaders.emplace_back(path, defines);
+        spdlog::trace("VCX::Engine::GL::ProgramPermutations::Get({})", key);
+        return _programs.try_emplace(key, std::span<SharedShader const>(shaders)).first->second;
+    }
+
     static void CheckProgram(GLuint const program) {
         GLint success;
         glGetProgramiv(program, GL_LINK_STATUS, &success);
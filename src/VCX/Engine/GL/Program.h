@@ -1,7 +1,11 @@
 #pragma once
 
+#include <filesystem>
 #include <initializer_list>
+#include <span>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 #include <glm/gtc/type_ptr.hpp>
 
@@ -24,13 +28,38 @@ namespace VCX::Engine::GL {
             _uniforms(Get()) {
         }
 
+        UniqueProgram(std::span<SharedShader const> const shaders):
+            Unique(CreateProgramFromShaders(shaders)),
+            _uniforms(Get()) {
+        }
+
         UniformCollection & GetUniforms() { return _uniforms; }
 
         void BindUniformBlock(char const * const name, std::uint32_t const bindingPoint) const;
 
     private:
         static GLuint CreateProgramFromShaders(std::initializer_list<SharedShader> const &);
+        static GLuint CreateProgramFromShaders(std::span<SharedShader const>);
 
         UniformCollection _uniforms;
     };
+
+    /**
+     * Compile-time specializations of one set of shader files. Each distinct define list is compiled
+     * and linked on first request and cached, so switching back to a variant costs a lookup.
+     */
+    class ProgramPermutations {
+    public:
+        ProgramPermutations(std::initializer_list<std::filesystem::path> && paths):
+            _paths(paths) {
+        }
+
+        UniqueProgram & Get(std::vector<std::string> const & defines);
+
+        std::size_t GetCount() const { return _programs.size(); }
+
+    private:
+        std::vector<std::filesystem::path>             _paths;
+        std::unordered_map<std::string, UniqueProgram> _programs;
+    };
 } // namespace VCX::Engine::GL
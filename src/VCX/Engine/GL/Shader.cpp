@@ -1,4 +1,6 @@
+#include <algorithm>
 #include <array>
+#include <string_view>
 
 #include <spdlog/spdlog.h>
 
@@ -29,6 +31,36 @@ namespace VCX::Engine::GL {
         CheckShader(shader);
     }
 
+    SharedShader::SharedShader(
+        std::filesystem::path const &    fileName,
+        std::vector<std::string> const & defines):
+        SharedShader(ShaderTypeFromExtension(fileName.extension()), LoadBytes(fileName), defines) {}
+
+    SharedShader::SharedShader(
+        ShaderType const                 type,
+        std::vector<std::byte> const &   blob,
+        std::vector<std::string> const & defines):
+        Shared(glCreateShader(GLenum(type))) {
+        // #version has to stay first, so the defines go in a second source string after its line.
+        std::string_view const source { reinterpret_cast<char const *>(blob.data()), blob.size() };
+        std::size_t            split { 0 };
+        if (auto const version { source.find("#version") }; version != std::string_view::npos) {
+            auto const lineEnd { source.find('\n', version) };
+            split = lineEnd == std::string_view::npos ? source.size() : lineEnd + 1;
+        }
+        std::string injected;
+        for (auto const & define : defines) injected += "#define " + define + "\n";
+        // keep compiler messages pointing at the lines of the file.
+        injected += "#line " + std::to_string(std::count(source.begin(), source.begin() + split, '\n') + 1) + "\n";
+
+        std::array<GLchar const *, 3> sources { source.data(), injected.data(), source.data() + split };
+        std::array<GLint, 3>          lengths { GLint(split), GLint(injected.size()), GLint(source.size() - split) };
+        auto const                    shader { Get() };
+        glShaderSource(shader, 3, sources.data(), lengths.data());
+        glCompileShader(shader);
+        CheckShader(shader);
+    }
+
     static ShaderType ShaderTypeFromExtension(std::filesystem::path const & ext) {
              if (ext == ".vert") return ShaderType::Vertex;
         else if (ext == ".tesc") return ShaderType::TessControl;
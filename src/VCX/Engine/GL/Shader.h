@@ -1,6 +1,8 @@
 #pragma once
 
 #include <filesystem>
+#include <string>
+#include <vector>
 
 #include "Engine/GL/resource.hpp"
 #include "Engine/prelude.hpp"
@@ -25,6 +27,10 @@ namespace VCX::Engine::GL {
         SharedShader(                  std::filesystem::path  const &);
         SharedShader(ShaderType const, std::filesystem::path  const &);
         SharedShader(ShaderType const, std::vector<std::byte> const &);
+
+        // permutations: each define ("NAME" or "NAME VALUE") becomes a #define right after the #version line.
+        SharedShader(                  std::filesystem::path  const &, std::vector<std::string> const & defines);
+        SharedShader(ShaderType const, std::vector<std::byte> const &, std::vector<std::string> const & defines);
         // clang-format on
     };
 } // namespace VCX::Engine::GL
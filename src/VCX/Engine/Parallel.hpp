@@ -0,0 +1,48 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace VCX::Engine {
+    // number of worker threads used by ParallelFor; at least one.
+    inline std::size_t GetWorkerCount() {
+        return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    // set while a thread runs a ParallelFor chunk; nested calls then run inline instead of oversubscribing.
+    inline thread_local bool tlsInParallelFor = false;
+
+    // run func(begin, end) over [0, count) split into chunks of at most grain items, on up to GetWorkerCount() threads.
+    // the calling thread takes part in the work; the call returns once every chunk is done.
+    // a ParallelFor issued from inside another one runs serially on the calling worker.
+    template<typename Func>
+    void ParallelFor(std::size_t count, std::size_t grain, Func && func) {
+        if (count == 0) return;
+        grain = std::max<std::size_t>(grain, 1);
+        std::size_t const chunks  = (count + grain - 1) / grain;
+        std::size_t const workers = std::min(GetWorkerCount(), chunks);
+        if (workers <= 1 || tlsInParallelFor) {
+            func(std::size_t(0), count);
+            return;
+        }
+
+        std::atomic<std::size_t> next { 0 };
+        auto const worker = [&]() {
+            bool const outer = tlsInParallelFor;
+            tlsInParallelFor = true;
+            for (std::size_t chunk = next.fetch_add(1); chunk < chunks; chunk = next.fetch_add(1)) {
+                std::size_t const begin = chunk * grain;
+                func(begin, std::min(begin + grain, count));
+            }
+            tlsInParallelFor = outer;
+        };
+        std::vector<std::thread> threads;
+        threads.reserve(workers - 1);
+        for (std::size_t i = 1; i < workers; ++i) threads.emplace_back(worker);
+        worker();
+        for (auto & thread : threads) thread.join();
+    }
+}